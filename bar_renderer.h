@@ -0,0 +1,197 @@
+/**
+ * @file bar_renderer.h
+ * @author Carlos Salguero
+ * @brief Batched, incremental rendering of the data as vertical bars
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BAR_RENDERER_H
+#define BAR_RENDERER_H
+
+#include <vector>
+#include <cstddef>
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @brief
+ * Draws one bar per element. The geometry of every frame is built into
+ * reusable rect buffers, one per color, and submitted with a single
+ * SDL_RenderFillRects call per color. Bars are kept in a target texture
+ * between frames, so only the bars whose value or highlight changed since
+ * the previous frame are drawn again.
+ */
+class bar_renderer
+{
+public:
+    /**
+     * @brief
+     * Construct a new bar renderer
+     * @param renderer Renderer where the render happens
+     * @param bar_count Number of bars (elements) to draw
+     * @param height Height of the drawing area, bars grow from its bottom
+     */
+    bar_renderer(SDL_Renderer *renderer, std::size_t bar_count, int height)
+        : renderer{renderer}, height{height},
+          previous(bar_count), previous_red{no_bar}, previous_blue{no_bar}
+    {
+        canvas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                   SDL_TEXTUREACCESS_TARGET,
+                                   static_cast<int>(bar_count), height);
+
+        clear_rects.reserve(bar_count);
+        white_rects.reserve(bar_count);
+    }
+
+    bar_renderer(const bar_renderer &) = delete;
+    bar_renderer &operator=(const bar_renderer &) = delete;
+
+    ~bar_renderer()
+    {
+        if (canvas)
+            SDL_DestroyTexture(canvas);
+    }
+
+    /**
+     * @brief
+     * Draws the data into the current render target. Does not present.
+     * @param data_vec Vector with the data
+     * @param red Index of the bar drawn in red
+     * @param blue Index of the bar drawn in blue
+     */
+    void draw(const std::vector<int> &data_vec, std::size_t red,
+              std::size_t blue)
+    {
+        clear_rects.clear();
+        white_rects.clear();
+        red_rects.clear();
+        blue_rects.clear();
+
+        // Without a persistent canvas every bar is drawn on every frame
+        bool full{!canvas || !valid};
+
+        for (std::size_t index{}; index < data_vec.size(); ++index)
+        {
+            bool highlighted{index == red || index == blue ||
+                             index == previous_red ||
+                             index == previous_blue};
+
+            if (!full && !highlighted && data_vec[index] == previous[index])
+                continue;
+
+            previous[index] = data_vec[index];
+            add_bar(index, data_vec[index], red, blue);
+        }
+
+        previous_red = red;
+        previous_blue = blue;
+
+        if (canvas)
+        {
+            SDL_SetRenderTarget(renderer, canvas);
+            submit(!valid);
+            SDL_SetRenderTarget(renderer, nullptr);
+
+            valid = true;
+
+            SDL_RenderCopy(renderer, canvas, nullptr, nullptr);
+        }
+
+        else
+            submit(true);
+    }
+
+    /**
+     * @brief
+     * Forces every bar to be drawn again on the next frame.
+     */
+    void invalidate() { valid = false; }
+
+private:
+    static constexpr std::size_t no_bar{static_cast<std::size_t>(-1)};
+
+    /**
+     * @brief
+     * Adds the geometry of one bar to the buffer of its color.
+     * @param index Index of the element
+     * @param value Value of the element
+     * @param red Index of the bar drawn in red
+     * @param blue Index of the bar drawn in blue
+     */
+    void add_bar(std::size_t index, int value, std::size_t red,
+                 std::size_t blue)
+    {
+        int x{static_cast<int>(index)};
+
+        clear_rects.push_back({x, 0, 1, height});
+
+        SDL_Rect bar{x, value, 1, height - value};
+
+        if (index == red)
+            red_rects.push_back(bar);
+
+        else if (index == blue)
+            blue_rects.push_back(bar);
+
+        else
+            white_rects.push_back(bar);
+    }
+
+    /**
+     * @brief
+     * Submits the batched geometry, one call per color.
+     * @param clear Whether the whole target is cleared first
+     */
+    void submit(bool clear)
+    {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+
+        if (clear)
+            SDL_RenderClear(renderer);
+
+        else
+            fill(clear_rects);
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        fill(white_rects);
+
+        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        fill(red_rects);
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+        fill(blue_rects);
+    }
+
+    /**
+     * @brief
+     * Fills a batch of rects with the current draw color.
+     * @param rects Rects to be filled
+     */
+    void fill(const std::vector<SDL_Rect> &rects)
+    {
+        if (!rects.empty())
+            SDL_RenderFillRects(renderer, rects.data(),
+                                static_cast<int>(rects.size()));
+    }
+
+    SDL_Renderer *renderer;
+    SDL_Texture *canvas{nullptr};
+    int height;
+    bool valid{false};
+
+    std::vector<int> previous;
+    std::size_t previous_red;
+    std::size_t previous_blue;
+
+    std::vector<SDL_Rect> clear_rects;
+    std::vector<SDL_Rect> white_rects;
+    std::vector<SDL_Rect> red_rects;
+    std::vector<SDL_Rect> blue_rects;
+};
+
+#endif //! BAR_RENDERER_H
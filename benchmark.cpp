@@ -0,0 +1,974 @@
+/**
+ * @file benchmark.cpp
+ * @author Carlos Salguero
+ * @brief Headless benchmark of every sorting algorithm
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <optional>
+#include <span>
+
+// Sorts
+#include "sorts.h"
+#include "parallel_sorts.h"
+#include "radix_sort.h"
+#include "operation_counter.h"
+#include "perf_counters.h"
+
+// Memory mapped datasets
+#include "mapped_file.h"
+
+// Generated inputs
+#include "input_generator.h"
+
+/**
+ * @brief
+ * Shape of the generated input. file inputs are the leading keys of the
+ * dataset given with --input.
+ */
+enum class input_shape
+{
+    random,
+    sorted,
+    reversed,
+    few_unique,
+    nearly_sorted,
+    sawtooth,
+    organ_pipe,
+    zipf,
+    file
+};
+
+// Shapes that can be asked for on the command line
+constexpr input_shape generated_shapes[]{
+    input_shape::random,        input_shape::sorted,
+    input_shape::reversed,      input_shape::few_unique,
+    input_shape::nearly_sorted, input_shape::sawtooth,
+    input_shape::organ_pipe,    input_shape::zipf};
+
+/**
+ * @brief
+ * A benchmarked algorithm. run sorts without recording anything and is the
+ * timed call; count sorts the same input again with an operation counter,
+ * and profile with hardware counters. Sorts that only take a comparator
+ * report their comparisons but no swaps, and no phases.
+ */
+struct algorithm_entry
+{
+    std::string name;
+    std::string direction;
+    std::function<void(std::vector<int> &)> run;
+    std::function<operation_counter(std::vector<int> &)> count;
+    std::function<void(std::vector<int> &, perf_recorder &)> profile;
+    std::function<bool(input_shape)> quadratic;
+    bool ascending;
+    bool counts_swaps;
+};
+
+/**
+ * @brief
+ * Result of all the repetitions of one algorithm over one input.
+ */
+struct measurement
+{
+    std::string algorithm;
+    std::string direction;
+    std::string shape;
+    std::size_t size;
+    unsigned int repetitions;
+    double ns_min;
+    double ns_median;
+    double ns_mean;
+    double ns_stddev;
+    operation_counter counter;
+    bool counted_swaps;
+    double throughput;
+    std::optional<perf_report> profile;
+};
+
+/**
+ * @brief
+ * Command line options of the benchmark.
+ */
+struct options
+{
+    std::vector<std::size_t> sizes{100, 1'000, 10'000, 100'000, 1'000'000,
+                                   10'000'000, 100'000'000};
+    std::vector<input_shape> shapes{input_shape::random, input_shape::sorted,
+                                    input_shape::reversed,
+                                    input_shape::few_unique,
+                                    input_shape::nearly_sorted};
+    std::vector<std::string> algorithms;
+    unsigned int repetitions{5};
+    std::size_t quadratic_limit{10'000};
+    std::string format{"csv"};
+    std::string output;
+    std::string input;
+    std::uint64_t seed{42};
+    bool counters{false};
+    unsigned int threads{work_stealing_pool::default_workers() + 1};
+};
+
+// Function prototypes
+std::vector<algorithm_entry> make_algorithms(work_stealing_pool &);
+std::vector<int> generate(input_shape, std::size_t, std::uint64_t,
+                          work_stealing_pool &);
+measurement run_benchmark(const algorithm_entry &, input_shape,
+                          const std::vector<int> &, unsigned int,
+                          const perf_counters *);
+void write_csv(std::ostream &, const std::vector<measurement> &);
+void write_json(std::ostream &, const std::vector<measurement> &);
+void write_sample_json(std::ostream &, const perf_sample &);
+std::vector<std::string> split(const std::string &);
+bool parse_options(int, char **, options &);
+const char *shape_name(input_shape);
+void usage();
+
+// Main function
+int main(int argc, char **argv)
+{
+    options opts;
+
+    if (!parse_options(argc, argv, opts))
+    {
+        usage();
+
+        return EXIT_FAILURE;
+    }
+
+    // Keys of the dataset, read straight from the page cache
+    std::optional<mapped_file> dataset;
+    std::span<const int> keys;
+
+    if (!opts.input.empty())
+    {
+        try
+        {
+            dataset.emplace(opts.input, map_mode::read_only);
+        }
+
+        catch (const std::exception &error)
+        {
+            std::cerr << "Error: " << error.what() << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        dataset->advise(access_pattern::sequential, true);
+        keys = dataset->as<const int>();
+    }
+
+    std::vector<measurement> results;
+    // The thread waiting on the pool runs tasks too
+    work_stealing_pool pool{opts.threads - 1};
+    auto algorithms{make_algorithms(pool)};
+
+    // Counters of the main thread; the workers of the engines are not seen
+    std::optional<perf_counters> counters;
+
+    if (opts.counters)
+    {
+        counters.emplace();
+
+        if (!counters->available())
+            std::cerr << "Warning: no hardware counter could be opened, "
+                         "only wall time is reported"
+                      << std::endl;
+    }
+
+    for (auto shape : opts.shapes)
+    {
+        for (auto size : opts.sizes)
+        {
+            if (shape == input_shape::file && size > keys.size())
+                continue;
+
+            auto input{shape == input_shape::file
+                           ? std::vector<int>(keys.begin(),
+                                              keys.begin() + size)
+                           : generate(shape, size, opts.seed, pool)};
+
+            for (const auto &algorithm : algorithms)
+            {
+                if (!opts.algorithms.empty() &&
+                    std::ranges::find(opts.algorithms, algorithm.name) ==
+                        opts.algorithms.end())
+                    continue;
+
+                if (algorithm.quadratic(shape) && size > opts.quadratic_limit)
+                    continue;
+
+                std::cerr << algorithm.name << " (" << algorithm.direction
+                          << ") " << shape_name(shape) << " n=" << size
+                          << std::endl;
+
+                results.push_back(run_benchmark(
+                    algorithm, shape, input, opts.repetitions,
+                    counters ? &*counters : nullptr));
+            }
+        }
+    }
+
+    std::ofstream file;
+
+    if (!opts.output.empty())
+    {
+        file.open(opts.output);
+
+        if (!file)
+        {
+            std::cerr << "Error: could not open " << opts.output << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ostream &out{opts.output.empty() ? std::cout : file};
+
+    if (opts.format == "json")
+        write_json(out, results);
+
+    else
+        write_csv(out, results);
+
+    return EXIT_SUCCESS;
+}
+
+// Function Declaration
+/**
+ * @brief
+ * Wraps one of the templates of sorts.h into a benchmark entry.
+ * @tparam Sort Callable taking the data, a comparator and a recorder
+ * @tparam Compare Ordering of the sort
+ * @param name Name of the algorithm
+ * @param direction Direction of the sort
+ * @param sort Sort to be benchmarked
+ * @param compare Ordering of the sort
+ * @param quadratic Whether the sort is O(n^2) on an input shape
+ * @param ascending Whether the sort is ascending
+ * @return algorithm_entry Benchmark entry
+ */
+template <typename Sort, typename Compare>
+algorithm_entry make_entry(std::string name, std::string direction, Sort sort,
+                           Compare compare,
+                           std::function<bool(input_shape)> quadratic,
+                           bool ascending)
+{
+    return {std::move(name), std::move(direction),
+            [sort, compare](std::vector<int> &data_vec)
+            {
+                null_recorder recorder;
+                sort(data_vec, compare, recorder);
+            },
+            [sort, compare](std::vector<int> &data_vec)
+            {
+                operation_counter counter;
+                sort(data_vec, compare, counter);
+
+                return counter;
+            },
+            [sort, compare](std::vector<int> &data_vec,
+                            perf_recorder &recorder)
+            { sort(data_vec, compare, recorder); },
+            std::move(quadratic), ascending, true};
+}
+
+/**
+ * @brief
+ * Wraps a sort that only takes a comparator (the standard library sorts and
+ * the parallel engines) into a benchmark entry. Comparisons are counted
+ * through the comparator; swaps are not reported.
+ * @tparam Sort Callable taking the data and a comparator
+ * @tparam Compare Ordering of the sort
+ * @param name Name of the algorithm
+ * @param direction Direction of the sort
+ * @param sort Sort to be benchmarked
+ * @param compare Ordering of the sort
+ * @param ascending Whether the sort is ascending
+ * @return algorithm_entry Benchmark entry
+ */
+template <typename Sort, typename Compare>
+algorithm_entry make_baseline(std::string name, std::string direction,
+                              Sort sort, Compare compare, bool ascending)
+{
+    return {std::move(name), std::move(direction),
+            [sort, compare](std::vector<int> &data_vec)
+            { sort(data_vec, compare); },
+            [sort, compare](std::vector<int> &data_vec)
+            {
+                std::atomic<std::uint64_t> comparisons{0};
+
+                sort(data_vec,
+                     [&](int a, int b)
+                     {
+                         comparisons.fetch_add(1, std::memory_order_relaxed);
+                         return compare(a, b);
+                     });
+
+                return operation_counter{comparisons.load(), 0, 0};
+            },
+            [sort, compare](std::vector<int> &data_vec, perf_recorder &)
+            { sort(data_vec, compare); },
+            [](input_shape) { return false; }, ascending, false};
+}
+
+/**
+ * @brief
+ * Wraps a sort that does not compare elements (the LSD radix engine) into
+ * a benchmark entry. No operations are reported.
+ * @tparam Sort Callable taking the data
+ * @param name Name of the algorithm
+ * @param direction Direction of the sort
+ * @param sort Sort to be benchmarked
+ * @param ascending Whether the sort is ascending
+ * @return algorithm_entry Benchmark entry
+ */
+template <typename Sort>
+algorithm_entry make_engine(std::string name, std::string direction,
+                            Sort sort, bool ascending)
+{
+    return {std::move(name), std::move(direction), sort,
+            [sort](std::vector<int> &data_vec)
+            {
+                sort(data_vec);
+
+                return operation_counter{};
+            },
+            [sort](std::vector<int> &data_vec, perf_recorder &)
+            { sort(data_vec); },
+            [](input_shape) { return false; }, ascending, false};
+}
+
+/**
+ * @brief
+ * Builds the list of benchmarked algorithms: every template of sorts.h in
+ * both directions, the parallel engines, and std::sort and
+ * std::stable_sort as baselines.
+ * @param pool Pool running the parallel engines
+ * @return std::vector<algorithm_entry> Benchmarked algorithms
+ */
+std::vector<algorithm_entry> make_algorithms(work_stealing_pool &pool)
+{
+    auto always{[](input_shape) { return true; }};
+    auto never{[](input_shape) { return false; }};
+
+    // The Lomuto partition degrades to O(n^2) on anything but random data
+    auto lomuto{[](input_shape shape)
+                { return shape != input_shape::random; }};
+
+    auto bubble{[](auto &data_vec, auto compare, auto &recorder)
+                { bubble_sort(data_vec, compare, {}, recorder); }};
+    auto selection{[](auto &data_vec, auto compare, auto &recorder)
+                   { selection_sort(data_vec, compare, {}, recorder); }};
+    auto insertion{[](auto &data_vec, auto compare, auto &recorder)
+                   { insertion_sort(data_vec, compare, {}, recorder); }};
+    auto quick{[](auto &data_vec, auto compare, auto &recorder)
+               { quick_sort(data_vec, compare, {}, recorder); }};
+    auto msd_radix{[](auto &data_vec, auto compare, auto &recorder)
+                   { msd_radix_sort(data_vec, compare, {}, recorder); }};
+    auto hybrid{[](auto &data_vec, auto compare, auto &recorder)
+                { hybrid_sort(data_vec, compare, {}, recorder); }};
+    auto merge{[](auto &data_vec, auto compare, auto &recorder)
+               { merge_sort(data_vec, compare, {}, recorder); }};
+
+    std::ranges::less less;
+    std::ranges::greater greater;
+
+    return {
+        make_entry("bubble_sort", "ascending", bubble, less, always, true),
+        make_entry("bubble_sort", "descending", bubble, greater, always,
+                   false),
+        make_entry("selection_sort", "ascending", selection, less, always,
+                   true),
+        make_entry("selection_sort", "descending", selection, greater,
+                   always, false),
+        make_entry("insertion_sort", "ascending", insertion, less, always,
+                   true),
+        make_entry("insertion_sort", "descending", insertion, greater,
+                   always, false),
+        make_entry("quick_sort", "ascending", quick, less, lomuto, true),
+        make_entry("quick_sort", "descending", quick, greater, lomuto,
+                   false),
+        make_entry("hybrid_sort", "ascending", hybrid, less, never, true),
+        make_entry("hybrid_sort", "descending", hybrid, greater, never,
+                   false),
+        make_entry("merge_sort", "ascending", merge, less, never, true),
+        make_entry("merge_sort", "descending", merge, greater, never, false),
+        make_entry("msd_radix_sort", "ascending", msd_radix, less, never,
+                   true),
+        make_entry("msd_radix_sort", "descending", msd_radix, greater, never,
+                   false),
+        make_engine("radix_sort", "ascending",
+                    [&pool](auto &data_vec)
+                    { radix_sort(data_vec, false, pool); },
+                    true),
+        make_engine("radix_sort", "descending",
+                    [&pool](auto &data_vec)
+                    { radix_sort(data_vec, true, pool); },
+                    false),
+        make_baseline("parallel_quick_sort", "ascending",
+                      [&pool](auto &data_vec, auto compare)
+                      { parallel_quick_sort(data_vec, compare, pool); },
+                      std::less<int>{}, true),
+        make_baseline("parallel_quick_sort", "descending",
+                      [&pool](auto &data_vec, auto compare)
+                      { parallel_quick_sort(data_vec, compare, pool); },
+                      std::greater<int>{}, false),
+        make_baseline("parallel_merge_sort", "ascending",
+                      [&pool](auto &data_vec, auto compare)
+                      { parallel_merge_sort(data_vec, compare, pool); },
+                      std::less<int>{}, true),
+        make_baseline("parallel_merge_sort", "descending",
+                      [&pool](auto &data_vec, auto compare)
+                      { parallel_merge_sort(data_vec, compare, pool); },
+                      std::greater<int>{}, false),
+        make_baseline("std_sort", "ascending",
+                      [](auto &data_vec, auto compare)
+                      { std::ranges::sort(data_vec, compare); },
+                      std::less<int>{}, true),
+        make_baseline("std_sort", "descending",
+                      [](auto &data_vec, auto compare)
+                      { std::ranges::sort(data_vec, compare); },
+                      std::greater<int>{}, false),
+        make_baseline("std_stable_sort", "ascending",
+                      [](auto &data_vec, auto compare)
+                      { std::ranges::stable_sort(data_vec, compare); },
+                      std::less<int>{}, true),
+        make_baseline("std_stable_sort", "descending",
+                      [](auto &data_vec, auto compare)
+                      { std::ranges::stable_sort(data_vec, compare); },
+                      std::greater<int>{}, false)};
+}
+
+/**
+ * @brief
+ * Generates the input of a benchmark. The same shape, size and seed always
+ * produce the same data, whatever the number of threads. Random keys span
+ * every non-negative int; the other shapes use values up to the size, so
+ * sorted and reversed inputs hold distinct keys.
+ * @param shape Shape of the input
+ * @param size Number of elements
+ * @param seed Seed of the generator
+ * @param pool Threads the generation is spread over
+ * @return std::vector<int> Generated data
+ */
+std::vector<int> generate(input_shape shape, std::size_t size,
+                          std::uint64_t seed, work_stealing_pool &pool)
+{
+    input_spec spec{input_distribution::uniform, seed, 0,
+                    static_cast<int>(std::max<std::size_t>(size, 1) - 1)};
+
+    switch (shape)
+    {
+    case input_shape::random:
+        spec.high = INT_MAX;
+        break;
+
+    case input_shape::sorted:
+        spec.distribution = input_distribution::sorted;
+        break;
+
+    case input_shape::reversed:
+        spec.distribution = input_distribution::reversed;
+        break;
+
+    case input_shape::few_unique:
+        spec.distribution = input_distribution::few_unique;
+        break;
+
+    case input_shape::nearly_sorted:
+        spec.distribution = input_distribution::partially_shuffled;
+        break;
+
+    case input_shape::sawtooth:
+        spec.distribution = input_distribution::sawtooth;
+        break;
+
+    case input_shape::organ_pipe:
+        spec.distribution = input_distribution::organ_pipe;
+        break;
+
+    case input_shape::zipf:
+        spec.distribution = input_distribution::zipf;
+        break;
+
+    case input_shape::file:
+        break;
+    }
+
+    std::vector<int> data_vec(size);
+
+    generate_input(data_vec, spec, &pool);
+
+    return data_vec;
+}
+
+/**
+ * @brief
+ * Times the repetitions of an algorithm over a fresh copy of the input,
+ * counts its operations once and, when asked, profiles one more run with
+ * the hardware counters.
+ * @param algorithm Benchmarked algorithm
+ * @param shape Shape of the input
+ * @param input Data to be sorted
+ * @param repetitions Number of timed runs
+ * @param counters Hardware counters, or nullptr to skip the profile run
+ * @return measurement Statistics of the runs
+ */
+measurement run_benchmark(const algorithm_entry &algorithm, input_shape shape,
+                          const std::vector<int> &input,
+                          unsigned int repetitions,
+                          const perf_counters *counters)
+{
+    std::vector<double> ns_per_element;
+    std::vector<int> data_vec;
+
+    for (unsigned int i{}; i < repetitions; ++i)
+    {
+        data_vec = input;
+
+        auto start{std::chrono::steady_clock::now()};
+        algorithm.run(data_vec);
+        auto elapsed{std::chrono::steady_clock::now() - start};
+
+        double ns{std::chrono::duration<double, std::nano>(elapsed).count()};
+        ns_per_element.push_back(ns / std::max<std::size_t>(input.size(), 1));
+    }
+
+    bool sorted{algorithm.ascending
+                    ? std::ranges::is_sorted(data_vec)
+                    : std::ranges::is_sorted(data_vec, std::greater<int>{})};
+
+    if (!sorted)
+        std::cerr << "Warning: " << algorithm.name << " ("
+                  << algorithm.direction << ") did not sort the input"
+                  << std::endl;
+
+    data_vec = input;
+    auto counter{algorithm.count(data_vec)};
+
+    std::optional<perf_report> profile;
+
+    if (counters)
+    {
+        perf_recorder recorder{*counters};
+
+        data_vec = input;
+        recorder.start();
+        algorithm.profile(data_vec, recorder);
+        recorder.stop();
+
+        profile = recorder.report();
+    }
+
+    std::ranges::sort(ns_per_element);
+
+    auto n{static_cast<double>(ns_per_element.size())};
+    double mean{std::accumulate(ns_per_element.begin(), ns_per_element.end(),
+                                0.0) /
+                n};
+    double variance{};
+
+    for (auto value : ns_per_element)
+        variance += (value - mean) * (value - mean);
+
+    auto middle{ns_per_element.size() / 2};
+    double median{ns_per_element.size() % 2
+                      ? ns_per_element[middle]
+                      : (ns_per_element[middle - 1] + ns_per_element[middle]) /
+                            2};
+
+    return {algorithm.name,
+            algorithm.direction,
+            shape_name(shape),
+            input.size(),
+            repetitions,
+            ns_per_element.front(),
+            median,
+            mean,
+            ns_per_element.size() > 1 ? std::sqrt(variance / (n - 1)) : 0.0,
+            counter,
+            algorithm.counts_swaps,
+            median > 0 ? 1e3 / median : 0.0,
+            profile};
+}
+
+/**
+ * @brief
+ * Writes the counters of an interval as a JSON object. Events that could
+ * not be counted are null.
+ * @param out Output stream
+ * @param sample Counters of the interval
+ */
+void write_sample_json(std::ostream &out, const perf_sample &sample)
+{
+    out << "{\"wall_ns\": " << sample.wall_ns;
+
+    for (std::size_t event{}; event < perf_event_count; ++event)
+    {
+        out << ", \"" << perf_event_names[event] << "\": ";
+
+        if (sample.available[event])
+            out << sample.values[event];
+
+        else
+            out << "null";
+    }
+
+    out << "}";
+}
+
+/**
+ * @brief
+ * Writes the results as CSV, one row per measurement. Profiled runs add
+ * the counters of the whole run; the phases are only in the JSON report.
+ * @param out Output stream
+ * @param results Measurements
+ */
+void write_csv(std::ostream &out, const std::vector<measurement> &results)
+{
+    bool profiled{std::ranges::any_of(results, [](const auto &result)
+                                      { return result.profile.has_value(); })};
+
+    out << "algorithm,direction,shape,size,repetitions,ns_per_element_min,"
+           "ns_per_element_median,ns_per_element_mean,"
+           "ns_per_element_stddev,comparisons,swaps,writes,"
+           "throughput_melements_per_s";
+
+    if (profiled)
+    {
+        out << ",profile_wall_ns";
+
+        for (const char *name : perf_event_names)
+            out << ',' << name;
+    }
+
+    out << '\n';
+
+    for (const auto &result : results)
+    {
+        out << result.algorithm << ',' << result.direction << ','
+            << result.shape << ',' << result.size << ','
+            << result.repetitions << ',' << result.ns_min << ','
+            << result.ns_median << ',' << result.ns_mean << ','
+            << result.ns_stddev << ',' << result.counter.comparisons << ',';
+
+        if (result.counted_swaps)
+            out << result.counter.swaps << ',' << result.counter.writes;
+
+        else
+            out << ',';
+
+        out << ',' << result.throughput;
+
+        if (profiled && result.profile)
+        {
+            const auto &total{result.profile->total};
+
+            out << ',' << total.wall_ns;
+
+            for (std::size_t event{}; event < perf_event_count; ++event)
+            {
+                out << ',';
+
+                if (total.available[event])
+                    out << total.values[event];
+            }
+        }
+
+        else if (profiled)
+            out << std::string(perf_event_count + 1, ',');
+
+        out << '\n';
+    }
+}
+
+/**
+ * @brief
+ * Writes the results as a JSON array, one object per measurement.
+ * @param out Output stream
+ * @param results Measurements
+ */
+void write_json(std::ostream &out, const std::vector<measurement> &results)
+{
+    out << "[\n";
+
+    for (std::size_t i{}; i < results.size(); ++i)
+    {
+        const auto &result{results[i]};
+
+        out << "  {\"algorithm\": \"" << result.algorithm
+            << "\", \"direction\": \"" << result.direction
+            << "\", \"shape\": \"" << result.shape
+            << "\", \"size\": " << result.size
+            << ", \"repetitions\": " << result.repetitions
+            << ", \"ns_per_element\": {\"min\": " << result.ns_min
+            << ", \"median\": " << result.ns_median
+            << ", \"mean\": " << result.ns_mean
+            << ", \"stddev\": " << result.ns_stddev
+            << "}, \"comparisons\": " << result.counter.comparisons;
+
+        if (result.counted_swaps)
+            out << ", \"swaps\": " << result.counter.swaps
+                << ", \"writes\": " << result.counter.writes;
+
+        else
+            out << ", \"swaps\": null, \"writes\": null";
+
+        out << ", \"throughput_melements_per_s\": " << result.throughput;
+
+        if (result.profile)
+        {
+            out << ", \"counters\": ";
+            write_sample_json(out, result.profile->total);
+            out << ", \"phases\": {";
+
+            bool first{true};
+
+            for (std::size_t phase{}; phase < sort_phase_count; ++phase)
+            {
+                if (!result.profile->phase_calls[phase])
+                    continue;
+
+                out << (first ? "" : ", ") << "\""
+                    << phase_name(static_cast<sort_phase>(phase))
+                    << "\": {\"calls\": "
+                    << result.profile->phase_calls[phase]
+                    << ", \"counters\": ";
+                write_sample_json(out, result.profile->phases[phase]);
+                out << "}";
+
+                first = false;
+            }
+
+            out << "}";
+        }
+
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    out << "]\n";
+}
+
+/**
+ * @brief
+ * Splits a comma separated list.
+ * @param list Comma separated list
+ * @return std::vector<std::string> Items of the list
+ */
+std::vector<std::string> split(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream{list};
+    std::string item;
+
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+            items.push_back(item);
+    }
+
+    return items;
+}
+
+/**
+ * @brief
+ * Parses the command line.
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param opts Parsed options
+ * @return true The command line is valid
+ * @return false The command line is invalid
+ */
+bool parse_options(int argc, char **argv, options &opts)
+{
+    try
+    {
+        for (int i{1}; i < argc; ++i)
+        {
+            std::string arg{argv[i]};
+
+            if (arg == "--help")
+                return false;
+
+            if (arg == "--counters")
+            {
+                opts.counters = true;
+                continue;
+            }
+
+            if (i + 1 >= argc)
+                return false;
+
+            std::string value{argv[++i]};
+
+            if (arg == "--sizes")
+            {
+                opts.sizes.clear();
+
+                for (const auto &item : split(value))
+                    opts.sizes.push_back(
+                        static_cast<std::size_t>(std::stod(item)));
+            }
+
+            else if (arg == "--shapes")
+            {
+                opts.shapes.clear();
+
+                for (const auto &item : split(value))
+                {
+                    bool found{false};
+
+                    for (auto shape : generated_shapes)
+                    {
+                        if (item == shape_name(shape))
+                        {
+                            opts.shapes.push_back(shape);
+                            found = true;
+                        }
+                    }
+
+                    if (!found)
+                        return false;
+                }
+            }
+
+            else if (arg == "--algorithms")
+                opts.algorithms = split(value);
+
+            else if (arg == "--repetitions")
+                opts.repetitions = std::max(std::stoi(value), 1);
+
+            else if (arg == "--quadratic-limit")
+                opts.quadratic_limit =
+                    static_cast<std::size_t>(std::stod(value));
+
+            else if (arg == "--format" && (value == "csv" || value == "json"))
+                opts.format = value;
+
+            else if (arg == "--output")
+                opts.output = value;
+
+            else if (arg == "--input")
+                opts.input = value;
+
+            else if (arg == "--seed")
+                opts.seed = std::stoull(value);
+
+            else if (arg == "--threads")
+                opts.threads = std::max(std::stoi(value), 1);
+
+            else if (arg == "--simd" && value == "scalar")
+                set_simd_level(simd_level::scalar);
+
+            else if (arg == "--simd" && value == "avx2")
+                set_simd_level(simd_level::avx2);
+
+            else if (arg == "--simd" && value == "avx512")
+                set_simd_level(simd_level::avx512);
+
+            else
+                return false;
+        }
+    }
+
+    catch (const std::exception &)
+    {
+        return false;
+    }
+
+    // A dataset replaces the generated inputs
+    if (!opts.input.empty())
+        opts.shapes = {input_shape::file};
+
+    return true;
+}
+
+/**
+ * @brief
+ * Name of an input shape, as used on the command line and in the reports.
+ * @param shape Input shape
+ * @return const char* Name of the shape
+ */
+const char *shape_name(input_shape shape)
+{
+    switch (shape)
+    {
+    case input_shape::random:
+        return "random";
+
+    case input_shape::sorted:
+        return "sorted";
+
+    case input_shape::reversed:
+        return "reversed";
+
+    case input_shape::few_unique:
+        return "few_unique";
+
+    case input_shape::nearly_sorted:
+        return "nearly_sorted";
+
+    case input_shape::sawtooth:
+        return "sawtooth";
+
+    case input_shape::organ_pipe:
+        return "organ_pipe";
+
+    case input_shape::zipf:
+        return "zipf";
+
+    case input_shape::file:
+        return "file";
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief
+ * Shows the command line options.
+ */
+void usage()
+{
+    std::cerr
+        << "Usage: SortBenchmark [options]\n"
+        << "  --sizes 1e2,1e3,...      Input sizes (default 1e2 to 1e8)\n"
+        << "  --shapes random,...      random, sorted, reversed, few_unique,"
+           " nearly_sorted,\n"
+        << "                           sawtooth, organ_pipe, zipf\n"
+        << "  --algorithms name,...    Only run these algorithms\n"
+        << "  --repetitions N          Timed runs per measurement (default "
+           "5)\n"
+        << "  --quadratic-limit N      Largest input given to O(n^2) cases "
+           "(default 1e4)\n"
+        << "  --format csv|json        Report format (default csv)\n"
+        << "  --output FILE            Write the report to FILE\n"
+        << "  --input FILE             Sort the leading int32 keys of FILE "
+           "instead of\n"
+        << "                           generated data (larger sizes are "
+           "skipped)\n"
+        << "  --seed N                 Seed of the input generator\n"
+        << "  --threads N              Threads of the parallel engines\n"
+        << "  --counters               Profile one more run with hardware "
+           "counters\n"
+        << "  --simd scalar|avx2|avx512  Partition kernel (default: best)\n";
+}
@@ -0,0 +1,1002 @@
+/**
+ * @file external_sort.h
+ * @author Carlos Salguero
+ * @brief External merge sort of binary files larger than memory
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Sorts
+#include "parallel_sorts.h"
+
+/**
+ * @brief
+ * Limits of an external sort.
+ */
+struct external_sort_options
+{
+    // Bytes the buffers of the sort may take, run generation and merge
+    // alike
+    std::size_t memory_limit{std::size_t{1} << 30};
+
+    // Directory of the run files; empty for the directory of the output
+    std::string temporary_directory;
+};
+
+/**
+ * @brief
+ * Phase of an external sort.
+ */
+enum class external_phase
+{
+    runs,
+    merge,
+    done
+};
+
+/**
+ * @brief
+ * Progress of an external sort, published as it runs so another thread
+ * can show it. Counts are in keys.
+ */
+struct external_progress
+{
+    std::atomic<external_phase> phase{external_phase::runs};
+    std::atomic<std::uint64_t> keys{};
+    std::atomic<std::uint64_t> done{};
+    std::atomic<std::uint64_t> runs{};
+    std::atomic<unsigned int> pass{};
+    std::atomic<unsigned int> passes{};
+};
+
+/**
+ * @brief
+ * Thread running the reads and writes of an external sort in the order
+ * they are submitted, while the calling thread sorts and merges. Jobs
+ * still queued when it is destroyed are dropped; the running one is
+ * waited for.
+ */
+class io_thread
+{
+public:
+    io_thread() : worker{[this](std::stop_token stop) { run(stop); }} {}
+
+    io_thread(const io_thread &) = delete;
+    io_thread &operator=(const io_thread &) = delete;
+
+    /**
+     * @brief
+     * Queues a job.
+     * @param job Read or write, returning the number of keys moved
+     * @return std::future<std::size_t> Result of the job, or its exception
+     */
+    std::future<std::size_t> submit(std::function<std::size_t()> job)
+    {
+        std::packaged_task<std::size_t()> task{std::move(job)};
+        auto result{task.get_future()};
+
+        {
+            std::lock_guard lock{mutex};
+            jobs.push_back(std::move(task));
+        }
+
+        ready.notify_one();
+
+        return result;
+    }
+
+private:
+    void run(std::stop_token stop)
+    {
+        while (true)
+        {
+            std::packaged_task<std::size_t()> task;
+
+            {
+                std::unique_lock lock{mutex};
+
+                if (!ready.wait(lock, stop, [this] { return !jobs.empty(); }))
+                    return;
+
+                task = std::move(jobs.front());
+                jobs.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable_any ready;
+    std::deque<std::packaged_task<std::size_t()>> jobs;
+
+    // Last, so it is joined before the queue is destroyed
+    std::jthread worker;
+};
+
+/**
+ * @brief
+ * File read and written at explicit offsets, so several runs of it can be
+ * read at once. Owns its descriptor. Errors are reported as
+ * std::system_error.
+ */
+class run_file
+{
+public:
+    /**
+     * @brief
+     * Construct a new run file
+     * @param path Path of the file
+     * @param flags Flags of open(2)
+     */
+    run_file(const std::string &path, int flags)
+        : descriptor{::open(path.c_str(), flags, 0644)}
+    {
+        if (descriptor < 0)
+            fail("could not open " + path);
+    }
+
+    run_file(const run_file &) = delete;
+    run_file &operator=(const run_file &) = delete;
+
+    run_file(run_file &&other) noexcept
+        : descriptor{std::exchange(other.descriptor, -1)}
+    {
+    }
+
+    run_file &operator=(run_file &&other) noexcept
+    {
+        std::swap(descriptor, other.descriptor);
+
+        return *this;
+    }
+
+    ~run_file()
+    {
+        if (descriptor >= 0)
+            ::close(descriptor);
+    }
+
+    /**
+     * @brief
+     * Creates a file for the runs of a sort. It is unlinked right away, so
+     * it disappears when closed, even if the sort is interrupted.
+     * @param directory Directory of the file
+     * @return run_file Handle of the file
+     */
+    static run_file temporary(const std::string &directory)
+    {
+        std::string path{directory + "/sort-runs-XXXXXX"};
+        int descriptor{::mkstemp(path.data())};
+
+        if (descriptor < 0)
+            fail("could not create a run file in " + directory);
+
+        ::unlink(path.c_str());
+
+        return run_file{descriptor};
+    }
+
+    /**
+     * @brief
+     * Size of the file.
+     * @return std::uint64_t Size in bytes
+     */
+    std::uint64_t size() const
+    {
+        struct stat info;
+
+        if (::fstat(descriptor, &info) != 0)
+            fail("could not stat a file");
+
+        return static_cast<std::uint64_t>(info.st_size);
+    }
+
+    /**
+     * @brief
+     * Reads up to size bytes at an offset, stopping early at the end of
+     * the file.
+     * @param data Receives the bytes
+     * @param size Number of bytes
+     * @param offset Offset in the file
+     * @return std::size_t Bytes read
+     */
+    std::size_t read_at(void *data, std::size_t size,
+                        std::uint64_t offset) const
+    {
+        auto bytes{static_cast<char *>(data)};
+        std::size_t total{};
+
+        while (total < size)
+        {
+            auto count{::pread(descriptor, bytes + total, size - total,
+                               static_cast<off_t>(offset + total))};
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                fail("could not read a file");
+            }
+
+            if (count == 0)
+                break;
+
+            total += static_cast<std::size_t>(count);
+        }
+
+        return total;
+    }
+
+    /**
+     * @brief
+     * Writes size bytes at an offset.
+     * @param data Bytes written
+     * @param size Number of bytes
+     * @param offset Offset in the file
+     */
+    void write_at(const void *data, std::size_t size,
+                  std::uint64_t offset) const
+    {
+        auto bytes{static_cast<const char *>(data)};
+        std::size_t total{};
+
+        while (total < size)
+        {
+            auto count{::pwrite(descriptor, bytes + total, size - total,
+                                static_cast<off_t>(offset + total))};
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                fail("could not write a file");
+            }
+
+            total += static_cast<std::size_t>(count);
+        }
+    }
+
+    /**
+     * @brief
+     * Flushes the written bytes of the file to the disk.
+     */
+    void sync() const
+    {
+        if (::fsync(descriptor) != 0)
+            fail("could not flush a file");
+    }
+
+private:
+    friend class staged_file;
+
+    explicit run_file(int descriptor) : descriptor{descriptor} {}
+
+    [[noreturn]] static void fail(const std::string &what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+    int descriptor{-1};
+};
+
+/**
+ * @brief
+ * Output written under a temporary name next to its target and renamed
+ * over it once complete, so the target keeps its old contents, which may
+ * be the input of the sort, until the new ones are on disk. The temporary
+ * file is removed if it is never committed.
+ */
+class staged_file
+{
+public:
+    /**
+     * @brief
+     * Construct a new staged file
+     * @param target Path the file replaces when committed
+     */
+    explicit staged_file(const std::string &target)
+        : target{target}, path{staging_path(target)}
+    {
+        int descriptor{::mkstemp(path.data())};
+
+        if (descriptor < 0)
+            throw std::system_error{errno, std::generic_category(),
+                                    "could not create a file next to " +
+                                        target};
+
+        file = run_file{descriptor};
+        ::fchmod(descriptor, 0644);
+    }
+
+    staged_file(const staged_file &) = delete;
+    staged_file &operator=(const staged_file &) = delete;
+
+    ~staged_file()
+    {
+        if (!committed)
+            ::unlink(path.c_str());
+    }
+
+    /**
+     * @brief
+     * File the output is written to.
+     * @return const run_file& Temporary file
+     */
+    const run_file &output() const { return file; }
+
+    /**
+     * @brief
+     * Flushes the file to the disk and renames it over the target.
+     */
+    void commit()
+    {
+        file.sync();
+
+        if (::rename(path.c_str(), target.c_str()) != 0)
+            throw std::system_error{errno, std::generic_category(),
+                                    "could not replace " + target};
+
+        committed = true;
+    }
+
+private:
+    static std::string staging_path(const std::string &target)
+    {
+        std::filesystem::path name{target};
+        std::string hidden{"."};
+
+        hidden += name.filename().string();
+        hidden += ".sorting-XXXXXX";
+
+        return (name.parent_path() / hidden).string();
+    }
+
+    std::string target;
+    std::string path;
+    run_file file{-1};
+    bool committed{false};
+};
+
+/**
+ * @brief
+ * Sorted run of a run file, in keys.
+ */
+struct run_extent
+{
+    std::uint64_t offset;
+    std::uint64_t count;
+};
+
+/**
+ * @brief
+ * Loser tree over k sources: a tournament whose inner nodes keep the loser
+ * of their match and whose root keeps the overall winner. Replacing the
+ * winner's key replays only its path to the root, log2(k) comparisons
+ * against the stored losers, where a binary heap takes two comparisons per
+ * level. Exhausted sources lose every match.
+ * @tparam T Type of the keys
+ * @tparam Compare Ordering of the keys
+ */
+template <typename T, typename Compare>
+class loser_tree
+{
+public:
+    /**
+     * @brief
+     * Construct a new loser tree
+     * @param sources Number of sources
+     * @param compare Ordering of the keys
+     */
+    loser_tree(std::size_t sources, Compare compare)
+        : keys(sources), closed(sources), nodes(sources),
+          compare{std::move(compare)}
+    {
+    }
+
+    /**
+     * @brief
+     * Current key of a source. Set the keys of every source before build,
+     * and the winner's next key before replay.
+     * @param source Index of the source
+     * @return T& Key of the source
+     */
+    T &key(std::size_t source) { return keys[source]; }
+
+    /**
+     * @brief
+     * Marks a source as exhausted.
+     * @param source Index of the source
+     */
+    void close(std::size_t source) { closed[source] = true; }
+
+    /**
+     * @brief
+     * Plays the whole tournament.
+     */
+    void build()
+    {
+        if (!nodes.empty())
+            nodes[0] = play(1);
+    }
+
+    /**
+     * @brief
+     * Replays the path of the winner after its key changed or its source
+     * was closed.
+     */
+    void replay()
+    {
+        auto winner{nodes[0]};
+
+        for (auto node{(winner + nodes.size()) / 2}; node > 0; node /= 2)
+        {
+            if (beats(nodes[node], winner))
+                std::swap(nodes[node], winner);
+        }
+
+        nodes[0] = winner;
+    }
+
+    std::size_t winner() const { return nodes[0]; }
+    bool empty() const { return nodes.empty() || closed[nodes[0]]; }
+
+private:
+    bool beats(std::size_t first, std::size_t second) const
+    {
+        if (closed[first] || closed[second])
+            return !closed[first];
+
+        return compare(keys[first], keys[second]);
+    }
+
+    // Leaves are nodes k to 2k - 1, so node n has children 2n and 2n + 1
+    std::size_t play(std::size_t node)
+    {
+        if (node >= nodes.size())
+            return node - nodes.size();
+
+        auto left{play(2 * node)};
+        auto right{play(2 * node + 1)};
+
+        if (beats(left, right))
+        {
+            nodes[node] = right;
+
+            return left;
+        }
+
+        nodes[node] = left;
+
+        return right;
+    }
+
+    std::vector<T> keys;
+    std::vector<unsigned char> closed;
+    std::vector<std::size_t> nodes;
+    Compare compare;
+};
+
+/**
+ * @brief
+ * Reads a run through two blocks: the merge consumes one while the I/O
+ * thread fills the other.
+ * @tparam T Type of the keys
+ */
+template <typename T>
+class run_reader
+{
+public:
+    /**
+     * @brief
+     * Construct a new run reader and starts reading the first block
+     * @param io Thread running the reads
+     * @param file Run file
+     * @param run Run read
+     * @param front First block
+     * @param back Second block, of the same size
+     */
+    run_reader(io_thread &io, const run_file &file, run_extent run,
+               std::span<T> front, std::span<T> back)
+        : io{&io}, file{&file}, run{run}, front{front}, back{back}
+    {
+        request();
+    }
+
+    /**
+     * @brief
+     * Next key of the run.
+     * @param key Receives the key
+     * @return true A key was read
+     * @return false The run is exhausted
+     */
+    bool next(T &key)
+    {
+        if (position == filled && !refill())
+            return false;
+
+        key = front[position++];
+
+        return true;
+    }
+
+private:
+    // Starts reading the next block of the run into the back block
+    void request()
+    {
+        auto count{static_cast<std::size_t>(
+            std::min<std::uint64_t>(back.size(), run.count - requested))};
+
+        if (!count)
+            return;
+
+        pending = io->submit(
+            [file = file, block = back.first(count),
+             offset = (run.offset + requested) * sizeof(T)]
+            {
+                if (file->read_at(block.data(), block.size_bytes(), offset) !=
+                    block.size_bytes())
+                    throw std::runtime_error{"run file is truncated"};
+
+                return block.size();
+            });
+
+        requested += count;
+    }
+
+    bool refill()
+    {
+        if (!pending.valid())
+            return false;
+
+        filled = pending.get();
+        position = 0;
+
+        std::swap(front, back);
+        request();
+
+        return true;
+    }
+
+    io_thread *io;
+    const run_file *file;
+    run_extent run;
+    std::span<T> front;
+    std::span<T> back;
+    std::future<std::size_t> pending;
+    std::uint64_t requested{};
+    std::size_t position{};
+    std::size_t filled{};
+};
+
+/**
+ * @brief
+ * Writes merged keys through two blocks: the merge fills one while the
+ * I/O thread writes the other.
+ * @tparam T Type of the keys
+ */
+template <typename T>
+class run_writer
+{
+public:
+    /**
+     * @brief
+     * Construct a new run writer
+     * @param io Thread running the writes
+     * @param file File written
+     * @param offset Offset in keys of the first key written
+     * @param front First block
+     * @param back Second block, of the same size
+     */
+    run_writer(io_thread &io, const run_file &file, std::uint64_t offset,
+               std::span<T> front, std::span<T> back)
+        : io{&io}, file{&file}, offset{offset}, front{front}, back{back}
+    {
+    }
+
+    void push(const T &key)
+    {
+        front[size++] = key;
+
+        if (size == front.size())
+            flush();
+    }
+
+    /**
+     * @brief
+     * Writes the last block and waits for every write.
+     */
+    void finish()
+    {
+        flush();
+
+        if (pending.valid())
+            pending.get();
+    }
+
+private:
+    void flush()
+    {
+        if (!size)
+            return;
+
+        // The back block is free again once its write is done
+        if (pending.valid())
+            pending.get();
+
+        pending = io->submit(
+            [file = file, block = front.first(size),
+             offset = offset * sizeof(T)]
+            {
+                file->write_at(block.data(), block.size_bytes(), offset);
+
+                return block.size();
+            });
+
+        offset += size;
+        size = 0;
+
+        std::swap(front, back);
+    }
+
+    io_thread *io;
+    const run_file *file;
+    std::uint64_t offset;
+    std::span<T> front;
+    std::span<T> back;
+    std::future<std::size_t> pending;
+    std::size_t size{};
+};
+
+/**
+ * @brief
+ * Merges sorted runs of a file into one run of another file with a loser
+ * tree. Every run and the output get two blocks of the arena.
+ * @tparam T Type of the keys
+ * @tparam Compare Ordering of the keys
+ * @param runs Runs merged
+ * @param source File of the runs
+ * @param target File written
+ * @param offset Offset in keys of the merged run in the target
+ * @param arena Memory of the blocks, room for 2 * (runs + 1) of them
+ * @param compare Ordering of the keys
+ * @param progress Receives the number of keys merged
+ * @param stop Stops the merge between two blocks
+ * @return true The runs were merged
+ * @return false The merge was stopped
+ */
+template <typename T, typename Compare>
+bool merge_runs(std::span<const run_extent> runs, const run_file &source,
+                const run_file &target, std::uint64_t offset,
+                std::span<T> arena, Compare compare,
+                external_progress &progress, std::stop_token stop)
+{
+    auto block{arena.size() / (2 * runs.size() + 2)};
+    auto take{[&, next = std::size_t{}]() mutable
+              { return arena.subspan(block * next++, block); }};
+
+    io_thread io;
+
+    std::vector<run_reader<T>> readers;
+    readers.reserve(runs.size());
+
+    for (const auto &run : runs)
+    {
+        auto front{take()};
+        readers.emplace_back(io, source, run, front, take());
+    }
+
+    auto front{take()};
+    run_writer<T> writer{io, target, offset, front, take()};
+
+    loser_tree<T, Compare> tree{runs.size(), std::move(compare)};
+
+    for (std::size_t index{}; index < readers.size(); ++index)
+    {
+        if (!readers[index].next(tree.key(index)))
+            tree.close(index);
+    }
+
+    tree.build();
+
+    while (!tree.empty())
+    {
+        std::size_t merged{};
+
+        for (; merged < block && !tree.empty(); ++merged)
+        {
+            auto winner{tree.winner()};
+
+            writer.push(tree.key(winner));
+
+            if (!readers[winner].next(tree.key(winner)))
+                tree.close(winner);
+
+            tree.replay();
+        }
+
+        progress.done.fetch_add(merged, std::memory_order_relaxed);
+
+        if (stop.stop_requested())
+            return false;
+    }
+
+    writer.finish();
+
+    return true;
+}
+
+/**
+ * @brief
+ * External merge sort of a binary file of fixed-width keys, for files
+ * larger than memory. The input is read in chunks of a third of the
+ * memory limit: while one chunk is sorted by every thread of the pool, the
+ * I/O thread reads the next one and writes the previous one to a run file.
+ * The runs are then merged with a loser tree, through double-buffered
+ * blocks so reading and writing overlap the merge. When there are too
+ * many runs for blocks of at least 256 KiB, groups of runs are merged into
+ * longer runs first. A file that fits in one chunk is sorted in memory.
+ * The output is written next to its target and renamed over it once on
+ * disk, so it may be the input file, which a stop or an error leaves
+ * untouched. Trailing bytes that do not make up a whole key are ignored.
+ * Errors are reported as std::system_error or std::runtime_error.
+ * @tparam T Type of the keys
+ * @tparam Compare Ordering of the keys
+ * @param input_path File sorted
+ * @param output_path File receiving the sorted keys, replaced
+ * @param options Memory limit and directory of the run files
+ * @param compare Ordering of the keys
+ * @param pool Pool sorting the chunks
+ * @param progress Receives the progress of the sort, or nullptr
+ * @param stop Stops the sort between two chunks or blocks
+ * @return true The output is sorted
+ * @return false The sort was stopped
+ */
+template <typename T, typename Compare = std::less<T>>
+bool external_sort(const std::string &input_path,
+                   const std::string &output_path,
+                   const external_sort_options &options, Compare compare = {},
+                   work_stealing_pool &pool = shared_pool(),
+                   external_progress *progress = nullptr,
+                   std::stop_token stop = {})
+{
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "external sort moves keys as raw bytes");
+
+    // Smallest block worth a disk request of its own
+    constexpr std::size_t min_block_bytes{std::size_t{1} << 18};
+
+    external_progress ignored;
+    auto &state{progress ? *progress : ignored};
+
+    auto directory{options.temporary_directory};
+
+    if (directory.empty())
+        directory = std::filesystem::path{output_path}.parent_path().string();
+
+    if (directory.empty())
+        directory = ".";
+
+    auto budget{std::max<std::size_t>(options.memory_limit / sizeof(T), 64)};
+    auto chunk{budget / 3};
+
+    std::vector<run_extent> runs;
+    std::unique_ptr<T[]> arena;
+    std::optional<run_file> spill;
+
+    {
+        run_file input{input_path, O_RDONLY};
+
+        auto keys{input.size() / sizeof(T)};
+
+        state.keys.store(keys, std::memory_order_relaxed);
+
+        // Fits in memory: one sort, no run file
+        if (keys <= chunk)
+        {
+            auto size{static_cast<std::size_t>(keys)};
+
+            arena = std::make_unique_for_overwrite<T[]>(size);
+
+            if (input.read_at(arena.get(), size * sizeof(T), 0) !=
+                size * sizeof(T))
+                throw std::runtime_error{input_path + " shrank while sorted"};
+
+            parallel_quick_sort(arena.get(), size, compare, pool);
+            state.done.store(keys, std::memory_order_relaxed);
+            state.runs.store(1, std::memory_order_relaxed);
+
+            staged_file output{output_path};
+
+            output.output().write_at(arena.get(), size * sizeof(T), 0);
+            output.commit();
+            state.phase.store(external_phase::done, std::memory_order_release);
+
+            return true;
+        }
+
+        arena = std::make_unique_for_overwrite<T[]>(budget);
+        spill.emplace(run_file::temporary(directory));
+
+        std::span<T> buffers[3];
+        std::future<std::size_t> reads[3];
+        std::future<std::size_t> writes[3];
+
+        for (std::size_t slot{}; slot < 3; ++slot)
+            buffers[slot] = {arena.get() + slot * chunk, chunk};
+
+        // Declared after the buffers and futures, so it is destroyed first
+        io_thread io;
+
+        auto chunks{(keys + chunk - 1) / chunk};
+
+        auto read{[&](std::uint64_t index)
+                  {
+                      auto first{index * chunk};
+                      auto block{buffers[index % 3].first(
+                          static_cast<std::size_t>(
+                              std::min<std::uint64_t>(chunk, keys - first)))};
+
+                      reads[index % 3] = io.submit(
+                          [&input, &input_path, block, first]
+                          {
+                              if (input.read_at(block.data(),
+                                                block.size_bytes(),
+                                                first * sizeof(T)) !=
+                                  block.size_bytes())
+                                  throw std::runtime_error{
+                                      input_path + " shrank while sorted"};
+
+                              return block.size();
+                          });
+                  }};
+
+        read(0);
+
+        for (std::uint64_t index{}; index < chunks; ++index)
+        {
+            auto slot{index % 3};
+            auto count{reads[slot].get()};
+
+            // The next chunk goes to the buffer whose run was written
+            // two chunks ago
+            if (index + 1 < chunks)
+            {
+                if (writes[(index + 1) % 3].valid())
+                    writes[(index + 1) % 3].get();
+
+                read(index + 1);
+            }
+
+            if (stop.stop_requested())
+                return false;
+
+            auto block{buffers[slot].first(count)};
+
+            parallel_quick_sort(block.data(), block.size(), compare, pool);
+
+            runs.push_back({index * chunk, count});
+
+            writes[slot] = io.submit(
+                [&spill, block, offset = index * chunk * sizeof(T)]
+                {
+                    spill->write_at(block.data(), block.size_bytes(), offset);
+
+                    return block.size();
+                });
+
+            state.done.fetch_add(count, std::memory_order_relaxed);
+            state.runs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        for (auto &write : writes)
+        {
+            if (write.valid())
+                write.get();
+        }
+    }
+
+    // Every run and the output take two blocks of the arena
+    auto max_fan_in{std::max<std::size_t>(
+        budget / (2 * std::max<std::size_t>(min_block_bytes / sizeof(T), 1)),
+        3) - 1};
+
+    unsigned int passes{1};
+
+    for (auto count{runs.size()}; count > max_fan_in;
+         count = (count + max_fan_in - 1) / max_fan_in)
+        ++passes;
+
+    state.passes.store(passes, std::memory_order_relaxed);
+    state.phase.store(external_phase::merge, std::memory_order_release);
+
+    std::span<T> memory{arena.get(), budget};
+
+    // Intermediate passes merge groups of runs into a new run file
+    while (runs.size() > max_fan_in)
+    {
+        auto merged{run_file::temporary(directory)};
+        std::vector<run_extent> longer;
+        std::uint64_t offset{};
+
+        state.pass.fetch_add(1, std::memory_order_relaxed);
+        state.done.store(0, std::memory_order_relaxed);
+
+        for (std::size_t first{}; first < runs.size(); first += max_fan_in)
+        {
+            std::span<const run_extent> group{
+                runs.data() + first,
+                std::min(max_fan_in, runs.size() - first)};
+
+            std::uint64_t count{};
+
+            for (const auto &run : group)
+                count += run.count;
+
+            if (!merge_runs(group, *spill, merged, offset, memory, compare,
+                            state, stop))
+                return false;
+
+            longer.push_back({offset, count});
+            offset += count;
+        }
+
+        runs = std::move(longer);
+        spill = std::move(merged);
+    }
+
+    state.pass.fetch_add(1, std::memory_order_relaxed);
+    state.done.store(0, std::memory_order_relaxed);
+
+    // The output replaces its target only once merged, so the input may
+    // be the target: a stop or an error leaves it untouched
+    staged_file output{output_path};
+
+    if (!merge_runs(std::span<const run_extent>{runs}, *spill,
+                    output.output(), 0, memory, compare, state, stop))
+        return false;
+
+    output.commit();
+
+    state.phase.store(external_phase::done, std::memory_order_release);
+
+    return true;
+}
+
+#endif //! EXTERNAL_SORT_H
@@ -0,0 +1,233 @@
+/**
+ * @file frame_graph.h
+ * @author Carlos Salguero
+ * @brief Live graph of the frame times of the render thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+// Zones and frames
+#include "profiler.h"
+#include "text_overlay.h"
+
+/**
+ * @brief
+ * Frame times of the render thread, drawn in the top right corner of the
+ * window when the profiler graph is on (F key). Every frame is a column,
+ * stacked with the time of each top-level zone and, in gray, the time no
+ * zone covered (mostly waiting for vsync). The line marks 60 fps and the
+ * graph tops out at twice that frame time.
+ */
+class frame_graph
+{
+public:
+    /**
+     * @brief
+     * Draws the graph and its legend into the current render target, in
+     * window pixels. Does not present. Draws nothing while the graph is
+     * off.
+     * @param renderer Renderer where the render happens
+     */
+    void draw(SDL_Renderer *renderer)
+    {
+        auto &global{profiler::instance()};
+
+        if (!global.graph_visible())
+            return;
+
+        auto frames{global.recent_frames()};
+        const auto &names{global.frame_categories()};
+
+        legend.set_lines(legend_lines(frames, names));
+        legend.draw(renderer);
+
+        float scale_x;
+        float scale_y;
+
+        SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+        SDL_RenderSetScale(renderer, 1, 1);
+
+        SDL_Rect viewport;
+        SDL_RenderGetViewport(renderer, &viewport);
+
+        auto box{legend.bounds()};
+        SDL_Rect graph{viewport.w - graph_width, box.y + box.h, graph_width,
+                       graph_height};
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 192);
+        SDL_RenderFillRect(renderer, &graph);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+        for (auto &batch : batches)
+            batch.clear();
+
+        int x{graph.x + graph_width -
+              static_cast<int>(frames.size()) * column_width};
+
+        for (const auto &frame : frames)
+        {
+            int bottom{graph.y + graph_height};
+            std::uint64_t covered{};
+
+            auto stack{[&](std::size_t batch, std::uint64_t ns)
+                       {
+                           int top{std::max(graph.y,
+                                            graph.y + graph_height -
+                                                pixels(covered + ns))};
+
+                           if (top < bottom)
+                               batches[batch].push_back(
+                                   {x, top, column_width, bottom - top});
+
+                           covered += ns;
+                           bottom = top;
+                       }};
+
+            for (std::size_t category{}; category < names.size(); ++category)
+                stack(category, frame.zones[category]);
+
+            auto total{frame.end - frame.start};
+            stack(profile_categories, total - std::min(total, covered));
+
+            x += column_width;
+        }
+
+        for (std::size_t batch{}; batch < batches.size(); ++batch)
+        {
+            if (batches[batch].empty())
+                continue;
+
+            const auto &color{palette[batch]};
+
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+            SDL_RenderFillRects(renderer, batches[batch].data(),
+                                static_cast<int>(batches[batch].size()));
+        }
+
+        // Swatches of the legend, in the blanks that start its lines
+        for (std::size_t line{1}; line <= names.size() + 1; ++line)
+        {
+            auto origin{legend.line_origin(line)};
+            const auto &color{
+                palette[line <= names.size() ? line - 1 : profile_categories]};
+            SDL_Rect swatch{origin.x, origin.y, glyph_height * legend_scale,
+                            glyph_height * legend_scale};
+
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+            SDL_RenderFillRect(renderer, &swatch);
+        }
+
+        int target{graph.y + graph_height - pixels(frame_budget_ns)};
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderDrawLine(renderer, graph.x, target,
+                           graph.x + graph_width - 1, target);
+
+        SDL_RenderSetScale(renderer, scale_x, scale_y);
+    }
+
+private:
+    static constexpr int column_width{2};
+    static constexpr int graph_width{column_width * profile_frame_count};
+    static constexpr int graph_height{80};
+    static constexpr int legend_scale{2};
+
+    // 60 fps; the graph is twice as tall
+    static constexpr std::uint64_t frame_budget_ns{16'666'667};
+
+    /**
+     * @brief
+     * Height of a time in the graph.
+     * @param ns Nanoseconds
+     * @return int Pixels, clamped to the graph
+     */
+    static int pixels(std::uint64_t ns)
+    {
+        auto height{ns * graph_height / (2 * frame_budget_ns)};
+
+        return static_cast<int>(
+            std::min<std::uint64_t>(height, graph_height));
+    }
+
+    /**
+     * @brief
+     * Mean frame time, and mean time per frame of every category.
+     * @param frames Frames of the graph
+     * @param names Names of the categories
+     * @return std::vector<std::string> Lines of the legend
+     */
+    static std::vector<std::string>
+    legend_lines(const std::vector<profile_frame> &frames,
+                 const std::vector<std::string> &names)
+    {
+        std::array<double, profile_categories> zones{};
+        double total{};
+
+        for (const auto &frame : frames)
+        {
+            total += static_cast<double>(frame.end - frame.start);
+
+            for (std::size_t category{}; category < names.size(); ++category)
+                zones[category] += static_cast<double>(frame.zones[category]);
+        }
+
+        double count{static_cast<double>(std::max<std::size_t>(frames.size(),
+                                                               1))};
+        double covered{};
+        char text[64];
+
+        std::snprintf(text, sizeof(text), "frame %.2f ms, %.0f fps",
+                      total / count / 1e6,
+                      total ? count / total * 1e9 : 0.0);
+
+        std::vector<std::string> lines{text};
+
+        for (std::size_t category{}; category < names.size(); ++category)
+        {
+            std::snprintf(text, sizeof(text), "   %s %.2f ms",
+                          names[category].c_str(),
+                          zones[category] / count / 1e6);
+            lines.push_back(text);
+            covered += zones[category];
+        }
+
+        std::snprintf(text, sizeof(text), "   untimed %.2f ms",
+                      std::max(total - covered, 0.0) / count / 1e6);
+        lines.push_back(text);
+
+        return lines;
+    }
+
+    // One color per category, then the untimed rest
+    static constexpr std::array<SDL_Color, profile_categories + 1> palette{{
+        {230, 80, 80, 255},
+        {80, 200, 90, 255},
+        {80, 140, 240, 255},
+        {240, 200, 60, 255},
+        {200, 90, 220, 255},
+        {70, 210, 210, 255},
+        {110, 110, 110, 255},
+    }};
+
+    text_overlay legend{legend_scale, overlay_anchor::top_right};
+    std::array<std::vector<SDL_Rect>, profile_categories + 1> batches;
+};
+
+#endif //! FRAME_GRAPH_H
@@ -0,0 +1,181 @@
+/**
+ * @file frame_scheduler.h
+ * @author Carlos Salguero
+ * @brief Decides how many operations of a log each animation frame shows
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+/**
+ * @brief
+ * How fast a log is played. A target duration plays any log in the same
+ * time, whatever its length; otherwise the rate is fixed in operations per
+ * second.
+ */
+struct playback_pacing
+{
+    double duration{15.0};
+    double ops_per_second{0.0};
+    double frame_rate{60.0};
+};
+
+/**
+ * @brief
+ * Frame pacing of the player. Every frame gets the operations that fit in
+ * the real time elapsed since the previous one, so the playback follows
+ * the wall clock instead of the operation count, and a frame never waits
+ * for more than one vsync. Supports pause, single step and speed changes.
+ */
+class frame_scheduler
+{
+public:
+    /**
+     * @brief
+     * Construct a new frame scheduler
+     * @param total Number of operations of the log
+     * @param pacing Target duration or rate of the playback
+     */
+    frame_scheduler(std::size_t total, const playback_pacing &pacing)
+        : total{total}, frame_period{1.0 / pacing.frame_rate},
+          last_frame{clock::now()}
+    {
+        rate = pacing.ops_per_second > 0
+                   ? pacing.ops_per_second
+                   : static_cast<double>(total) /
+                         std::max(pacing.duration, min_duration);
+    }
+
+    /**
+     * @brief
+     * Number of operations the frame being built should apply. Called once
+     * per frame, right before applying them.
+     * @return std::size_t Operations of the frame
+     */
+    std::size_t next_frame()
+    {
+        auto now{clock::now()};
+
+        // A stalled frame (window dragged, debugger) must not make the
+        // next one jump ahead
+        double elapsed{std::min(
+            std::chrono::duration<double>(now - last_frame).count(),
+            max_frame_time)};
+
+        last_frame = now;
+
+        std::size_t count{};
+
+        if (paused)
+        {
+            count = pending_steps;
+            pending_steps = 0;
+            budget = 0;
+        }
+
+        else
+        {
+            budget += elapsed * rate * speed;
+            count = static_cast<std::size_t>(budget);
+            budget -= static_cast<double>(count);
+        }
+
+        count = std::min(count, total - played);
+        played += count;
+
+        return count;
+    }
+
+    /**
+     * @brief
+     * Sleeps until the next frame is due. Renderers with vsync already
+     * block in SDL_RenderPresent, so this only waits when presenting
+     * returned early.
+     */
+    void wait_for_frame() const
+    {
+        auto due{last_frame + std::chrono::duration_cast<clock::duration>(
+                                  std::chrono::duration<double>(frame_period))};
+
+        std::this_thread::sleep_until(due);
+    }
+
+    /**
+     * @brief
+     * Gives back operations the last frame was granted but could not apply,
+     * because the sort has not produced them yet. The playback falls behind
+     * the clock instead of catching up in a burst.
+     * @param count Operations not applied
+     */
+    void defer(std::size_t count)
+    {
+        played -= count;
+
+        if (paused)
+            pending_steps += count;
+    }
+
+    /**
+     * @brief
+     * Moves the playback to an operation of a source that can seek. The
+     * time budget and the pending steps start over from there.
+     * @param position Operations already played
+     */
+    void seek(std::size_t position)
+    {
+        played = std::min(position, total);
+        pending_steps = 0;
+        budget = 0;
+    }
+
+    bool finished() const { return played >= total; }
+
+    void toggle_pause() { paused = !paused; }
+
+    /**
+     * @brief
+     * Pauses the playback and plays a single operation on the next frame.
+     */
+    void step()
+    {
+        paused = true;
+        ++pending_steps;
+    }
+
+    void faster() { speed = std::min(speed * 2, max_speed); }
+
+    void slower() { speed = std::max(speed / 2, 1 / max_speed); }
+
+    bool is_paused() const { return paused; }
+    double speed_factor() const { return speed; }
+    std::size_t position() const { return played; }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr double max_frame_time{0.1};
+    static constexpr double min_duration{1e-3};
+    static constexpr double max_speed{1024.0};
+
+    std::size_t total;
+    std::size_t played{};
+    double frame_period;
+    double rate;
+    double speed{1.0};
+    double budget{};
+    bool paused{false};
+    std::size_t pending_steps{};
+    clock::time_point last_frame;
+};
+
+#endif //! FRAME_SCHEDULER_H
@@ -0,0 +1,285 @@
+/**
+ * @file indirect_sort.h
+ * @author Carlos Salguero
+ * @brief Sorts of wide records through a permutation of their indices
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef INDIRECT_SORT_H
+#define INDIRECT_SORT_H
+
+#include <vector>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Sorts
+#include "sorts.h"
+
+// Records up to this size are swapped directly; wider ones are sorted
+// through a permutation and moved once at the end
+inline constexpr std::size_t indirect_record_size{64};
+
+/**
+ * @brief
+ * Identity permutation of size indices. Indices are 32 bits, half the
+ * memory traffic of std::size_t while sorting them.
+ * @param size Number of records
+ * @return std::vector<std::uint32_t> Indices 0 to size - 1
+ */
+inline std::vector<std::uint32_t> identity_permutation(std::size_t size)
+{
+    if (size > UINT32_MAX)
+        throw std::length_error{"too many records for 32-bit indices"};
+
+    std::vector<std::uint32_t> order(size);
+    std::iota(order.begin(), order.end(), std::uint32_t{});
+
+    return order;
+}
+
+/**
+ * @brief
+ * Argsort: the indices of [first, last) in the order the records would be
+ * sorted, without moving a record. Every comparison projects the records
+ * through the indices, so records of any size and type (move-only
+ * included) cost the same to sort. Not stable. The recorder receives the
+ * operations on the permutation, which match the moves the records would
+ * make.
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First record
+ * @param last End of the records
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ * @return std::vector<std::uint32_t> Index of the record at each position
+ * of the sorted sequence
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::indirect_strict_weak_order<Compare,
+                                             std::projected<I, Proj>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+std::vector<std::uint32_t> argsort(I first, S last, Compare compare = {},
+                                   Proj proj = {}, Recorder &&recorder = {})
+{
+    auto order{identity_permutation(
+        static_cast<std::size_t>(std::ranges::distance(first, last)))};
+
+    hybrid_sort(order, std::move(compare),
+                [&](std::uint32_t index) -> decltype(auto)
+                { return std::invoke(proj, first[index]); },
+                recorder);
+
+    return order;
+}
+
+/**
+ * @brief
+ * Argsort over cached keys. The projected key of every record is copied
+ * next to its index once, and the pairs are sorted, so comparisons read
+ * contiguous memory instead of chasing an index into the records. Meant
+ * for small keys (integers, floats) of wide records.
+ * @return std::vector<std::uint32_t> Index of the record at each position
+ * of the sorted sequence
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::indirect_strict_weak_order<Compare,
+                                             std::projected<I, Proj>> &&
+             std::copyable<std::iter_value_t<std::projected<I, Proj>>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+std::vector<std::uint32_t> argsort_cached(I first, S last,
+                                          Compare compare = {},
+                                          Proj proj = {},
+                                          Recorder &&recorder = {})
+{
+    using key_type = std::iter_value_t<std::projected<I, Proj>>;
+
+    struct keyed_index
+    {
+        key_type key;
+        std::uint32_t index;
+    };
+
+    auto order{identity_permutation(
+        static_cast<std::size_t>(std::ranges::distance(first, last)))};
+
+    std::vector<keyed_index> pairs;
+    pairs.reserve(order.size());
+
+    for (auto index : order)
+        pairs.push_back({std::invoke(proj, first[index]), index});
+
+    hybrid_sort(pairs, std::move(compare), &keyed_index::key, recorder);
+
+    for (std::size_t i{}; i < pairs.size(); ++i)
+        order[i] = pairs[i].index;
+
+    return order;
+}
+
+/**
+ * @brief
+ * Rearranges [first, first + order.size()) so the record at position i is
+ * the one that was at order[i]. Follows the cycles of the permutation: the
+ * first record of a cycle is moved out, the others move once into the
+ * hole left by the previous one, and the first one fills the last hole.
+ * Every record is moved exactly once plus one move per cycle, and none is
+ * copied. The permutation is consumed, it is left as the identity; it
+ * must hold every index once.
+ * @tparam I Random access iterator
+ * @param first First record
+ * @param order Index of the record each position receives
+ */
+template <std::random_access_iterator I>
+    requires std::movable<std::iter_value_t<I>>
+void apply_permutation(I first, std::span<std::uint32_t> order)
+{
+    for (std::size_t start{}; start < order.size(); ++start)
+    {
+        if (order[start] == start)
+            continue;
+
+        std::iter_value_t<I> held{std::ranges::iter_move(first + start)};
+        auto hole{start};
+
+        while (order[hole] != start)
+        {
+            auto source{order[hole]};
+
+            first[hole] = std::ranges::iter_move(first + source);
+            order[hole] = static_cast<std::uint32_t>(hole);
+            hole = source;
+        }
+
+        first[hole] = std::move(held);
+        order[hole] = static_cast<std::uint32_t>(hole);
+    }
+}
+
+/**
+ * @brief
+ * Sorts records by a key, picking how they move by their size. Records of
+ * up to indirect_record_size bytes are sorted in place by the hybrid sort.
+ * Wider ones are argsorted (over cached keys when the key is a small
+ * trivially copyable value) and then moved once each into place, instead
+ * of being swapped some log n times.
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @param first First record
+ * @param last End of the records
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+    requires std::sortable<I, Compare, Proj>
+void record_sort(I first, S last, Compare compare = {}, Proj proj = {})
+{
+    using key_type = std::iter_value_t<std::projected<I, Proj>>;
+
+    if constexpr (sizeof(std::iter_value_t<I>) <= indirect_record_size)
+        hybrid_sort(first, last, std::move(compare), std::move(proj));
+
+    else
+    {
+        std::vector<std::uint32_t> order;
+
+        if constexpr (std::is_trivially_copyable_v<key_type> &&
+                      sizeof(key_type) <= sizeof(std::uint64_t))
+            order = argsort_cached(first, last, std::move(compare),
+                                   std::move(proj));
+
+        else
+            order = argsort(first, last, std::move(compare), std::move(proj));
+
+        apply_permutation(first, std::span{order});
+    }
+}
+
+/**
+ * @brief
+ * Argsort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::indirect_strict_weak_order<
+                 Compare, std::projected<std::ranges::iterator_t<R>, Proj>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+std::vector<std::uint32_t> argsort(R &&range, Compare compare = {},
+                                   Proj proj = {}, Recorder &&recorder = {})
+{
+    return argsort(std::ranges::begin(range), std::ranges::end(range),
+                   std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Argsort over cached keys of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::indirect_strict_weak_order<
+                 Compare, std::projected<std::ranges::iterator_t<R>, Proj>> &&
+             std::copyable<std::iter_value_t<
+                 std::projected<std::ranges::iterator_t<R>, Proj>>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+std::vector<std::uint32_t> argsort_cached(R &&range, Compare compare = {},
+                                          Proj proj = {},
+                                          Recorder &&recorder = {})
+{
+    return argsort_cached(std::ranges::begin(range), std::ranges::end(range),
+                          std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Permutation applied to a whole range
+ */
+template <std::ranges::random_access_range R>
+    requires std::movable<std::ranges::range_value_t<R>>
+void apply_permutation(R &&range, std::span<std::uint32_t> order)
+{
+    apply_permutation(std::ranges::begin(range), order);
+}
+
+/**
+ * @brief
+ * Record sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj>
+void record_sort(R &&range, Compare compare = {}, Proj proj = {})
+{
+    record_sort(std::ranges::begin(range), std::ranges::end(range),
+                std::move(compare), std::move(proj));
+}
+
+#endif //! INDIRECT_SORT_H
@@ -0,0 +1,458 @@
+/**
+ * @file input_generator.h
+ * @author Carlos Salguero
+ * @brief Seedable, parallel generator of the inputs of the sorts
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef INPUT_GENERATOR_H
+#define INPUT_GENERATOR_H
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "thread_pool.h"
+
+/**
+ * @brief
+ * Shape of a generated input.
+ */
+enum class input_distribution
+{
+    uniform,
+    sorted,
+    reversed,
+    sawtooth,
+    few_unique,
+    zipf,
+    organ_pipe,
+    partially_shuffled
+};
+
+inline constexpr input_distribution input_distributions[]{
+    input_distribution::uniform,    input_distribution::sorted,
+    input_distribution::reversed,   input_distribution::sawtooth,
+    input_distribution::few_unique, input_distribution::zipf,
+    input_distribution::organ_pipe, input_distribution::partially_shuffled};
+
+/**
+ * @brief
+ * What to generate. Values fall in [low, high], which may span the whole
+ * range of int. The same spec and size always produce the same data,
+ * whatever the number of threads.
+ */
+struct input_spec
+{
+    input_distribution distribution{input_distribution::uniform};
+    std::uint64_t seed{42};
+    int low{0};
+    int high{INT_MAX};
+
+    // Exponent of the Zipf distribution; 1 is the classic word frequency
+    double zipf_exponent{1.0};
+};
+
+/**
+ * @brief
+ * Steps a SplitMix64 sequence and returns its next output. Used to expand
+ * a single seed into the state of the generators.
+ * @param state State of the sequence
+ * @return std::uint64_t Next output
+ */
+inline std::uint64_t splitmix64(std::uint64_t &state)
+{
+    auto z{state += 0x9e3779b97f4a7c15};
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief
+ * xoshiro256** generator: a few shifts, rotations and one multiply per 64
+ * bits, several times faster than std::mt19937_64 with a 2^256 - 1 period.
+ * A seed and a stream number select the sequence, so parallel workers get
+ * their own streams from one seed. Meets UniformRandomBitGenerator.
+ */
+class xoshiro256
+{
+public:
+    using result_type = std::uint64_t;
+
+    /**
+     * @brief
+     * Construct a new generator
+     * @param seed Seed shared by every stream
+     * @param stream Number of the stream
+     */
+    explicit xoshiro256(std::uint64_t seed, std::uint64_t stream = 0)
+    {
+        std::uint64_t mix{seed};
+
+        mix = splitmix64(mix) ^ (stream * 0xd1b54a32d192ed03);
+
+        for (auto &word : state)
+            word = splitmix64(mix);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()()
+    {
+        auto result{std::rotl(state[1] * 5, 7) * 9};
+        auto shifted{state[1] << 17};
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = std::rotl(state[3], 45);
+
+        return result;
+    }
+
+    /**
+     * @brief
+     * Number in [0, bound) from the high bits of the next output, with a
+     * multiply instead of a division. The bias is below 2^-32 per value.
+     * @param bound Number of values, at most 2^32
+     * @return std::uint64_t Number drawn
+     */
+    std::uint64_t below(std::uint64_t bound)
+    {
+        return ((*this)() >> 32) * bound >> 32;
+    }
+
+    /**
+     * @brief
+     * Number in [0, 1) with 53 random bits.
+     * @return double Number drawn
+     */
+    double unit() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+private:
+    std::uint64_t state[4];
+};
+
+/**
+ * @brief
+ * Zipf distribution over the ranks [1, count]: rank k is drawn with a
+ * probability proportional to 1 / k^exponent, so a few keys are very
+ * common and most are rare. Sampled by rejection-inversion (Hormann and
+ * Derflinger), which takes constant time whatever the count, instead of
+ * searching a table of count cumulative weights.
+ */
+class zipf_distribution
+{
+public:
+    /**
+     * @brief
+     * Construct a new Zipf distribution
+     * @param count Number of ranks
+     * @param exponent Exponent of the ranks, above 0
+     */
+    zipf_distribution(std::uint64_t count, double exponent)
+        : count{static_cast<double>(count)}, exponent{exponent},
+          integral_first{integral(1.5) - 1},
+          integral_last{integral(this->count + 0.5)},
+          squeeze{2 - inverse(integral(2.5) - density(2))}
+    {
+    }
+
+    /**
+     * @brief
+     * Draws a rank.
+     * @param rng Generator of the stream
+     * @return std::uint64_t Rank in [1, count]
+     */
+    std::uint64_t operator()(xoshiro256 &rng) const
+    {
+        while (true)
+        {
+            double u{integral_last +
+                     rng.unit() * (integral_first - integral_last)};
+            double x{inverse(u)};
+            double k{std::clamp(std::floor(x + 0.5), 1.0, count)};
+
+            if (k - x <= squeeze || u >= integral(k + 0.5) - density(k))
+                return static_cast<std::uint64_t>(k);
+        }
+    }
+
+private:
+    double density(double x) const
+    {
+        return std::exp(-exponent * std::log(x));
+    }
+
+    // Integral of the density, (x^(1 - s) - 1) / (1 - s), or log(x) for
+    // s = 1; expm1 and log1p keep it exact around s = 1
+    double integral(double x) const
+    {
+        double log_x{std::log(x)};
+
+        return ratio_expm1((1 - exponent) * log_x) * log_x;
+    }
+
+    double inverse(double y) const
+    {
+        double t{std::max(y * (1 - exponent), -1.0)};
+
+        return std::exp(ratio_log1p(t) * y);
+    }
+
+    static double ratio_expm1(double x)
+    {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x / 2;
+    }
+
+    static double ratio_log1p(double x)
+    {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x / 2;
+    }
+
+    double count;
+    double exponent;
+    double integral_first;
+    double integral_last;
+    double squeeze;
+};
+
+/**
+ * @brief
+ * Name of a distribution, as used on the command line.
+ * @param distribution Distribution
+ * @return const char* Name of the distribution
+ */
+inline const char *distribution_name(input_distribution distribution)
+{
+    switch (distribution)
+    {
+    case input_distribution::uniform:
+        return "uniform";
+
+    case input_distribution::sorted:
+        return "sorted";
+
+    case input_distribution::reversed:
+        return "reversed";
+
+    case input_distribution::sawtooth:
+        return "sawtooth";
+
+    case input_distribution::few_unique:
+        return "few_unique";
+
+    case input_distribution::zipf:
+        return "zipf";
+
+    case input_distribution::organ_pipe:
+        return "organ_pipe";
+
+    case input_distribution::partially_shuffled:
+        return "partially_shuffled";
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief
+ * Distribution with a given name.
+ * @param name Name of the distribution
+ * @return std::optional<input_distribution> Distribution, or nothing for
+ * an unknown name
+ */
+inline std::optional<input_distribution>
+parse_distribution(const std::string &name)
+{
+    for (auto distribution : input_distributions)
+    {
+        if (name == distribution_name(distribution))
+            return distribution;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief
+ * Fills data_vec with an input. The array is cut into blocks of 64K
+ * elements, and each block draws from its own stream of the seed, so the
+ * blocks can be filled in any order by any number of threads and still
+ * give the same data. Shuffles of the partially shuffled input stay within
+ * a block for the same reason.
+ * @param data_vec Receives the input
+ * @param spec Distribution, seed and range of the values
+ * @param pool Pool the blocks are spread over, or nullptr to fill them on
+ * the calling thread
+ */
+inline void generate_input(std::span<int> data_vec, const input_spec &spec,
+                           work_stealing_pool *pool = nullptr)
+{
+    constexpr std::size_t block_size{1 << 16};
+    constexpr std::uint64_t unique_keys{16};
+    constexpr std::size_t teeth{16};
+
+    auto size{data_vec.size()};
+    auto blocks{(size + block_size - 1) / block_size};
+
+    auto low{static_cast<std::int64_t>(spec.low)};
+    auto range{static_cast<std::uint64_t>(spec.high - low + 1)};
+
+    auto value_at{[&](std::uint64_t offset)
+                  {
+                      return static_cast<int>(
+                          low + static_cast<std::int64_t>(offset));
+                  }};
+
+    // Writes the values of the positions position, position + 1... out of
+    // count spread over the range, to [first, last) forwards or backwards.
+    // The quotient is stepped with its remainder instead of dividing for
+    // every element.
+    auto ramp{[&](std::size_t first, std::size_t last, std::uint64_t position,
+                  std::uint64_t count, bool forward)
+              {
+                  auto value{position * range / count};
+                  auto remainder{position * range % count};
+                  auto step{range / count};
+                  auto carry{range % count};
+
+                  for (std::size_t k{}; k < last - first; ++k)
+                  {
+                      data_vec[forward ? first + k : last - 1 - k] =
+                          value_at(value);
+
+                      value += step;
+                      remainder += carry;
+
+                      if (remainder >= count)
+                      {
+                          ++value;
+                          remainder -= count;
+                      }
+                  }
+              }};
+
+    int keys[unique_keys];
+
+    for (std::uint64_t key{}; key < unique_keys; ++key)
+        keys[key] = value_at(key * range / unique_keys);
+
+    std::optional<zipf_distribution> zipf;
+
+    if (spec.distribution == input_distribution::zipf)
+        zipf.emplace(range, spec.zipf_exponent);
+
+    auto tooth{std::max<std::size_t>((size + teeth - 1) / teeth, 1)};
+    auto half{(size + 1) / 2};
+
+    auto fill_block{[&](std::size_t block)
+                    {
+                        auto begin{block * block_size};
+                        auto end{std::min(size, begin + block_size)};
+
+                        xoshiro256 rng{spec.seed, block};
+
+                        switch (spec.distribution)
+                        {
+                        case input_distribution::uniform:
+                            for (auto i{begin}; i < end; ++i)
+                                data_vec[i] = value_at(rng.below(range));
+
+                            break;
+
+                        case input_distribution::sorted:
+                        case input_distribution::partially_shuffled:
+                            ramp(begin, end, begin, size, true);
+                            break;
+
+                        case input_distribution::reversed:
+                            ramp(begin, end, size - end, size, false);
+                            break;
+
+                        case input_distribution::sawtooth:
+                            for (auto i{begin}; i < end;)
+                            {
+                                auto stop{
+                                    std::min(end, (i / tooth + 1) * tooth)};
+
+                                ramp(i, stop, i % tooth, tooth, true);
+                                i = stop;
+                            }
+
+                            break;
+
+                        case input_distribution::few_unique:
+                            for (auto i{begin}; i < end; ++i)
+                                data_vec[i] = keys[rng.below(unique_keys)];
+
+                            break;
+
+                        case input_distribution::zipf:
+                            for (auto i{begin}; i < end; ++i)
+                                data_vec[i] = value_at((*zipf)(rng) - 1);
+
+                            break;
+
+                        case input_distribution::organ_pipe:
+                            if (begin < half)
+                                ramp(begin, std::min(end, half), begin, half,
+                                     true);
+
+                            if (end > half)
+                                ramp(std::max(begin, half), end, size - end,
+                                     half, false);
+
+                            break;
+                        }
+
+                        // One element in a hundred trades places
+                        if (spec.distribution ==
+                            input_distribution::partially_shuffled)
+                        {
+                            auto length{end - begin};
+
+                            for (auto swaps{length / 100 + 1}; swaps--;)
+                                std::swap(data_vec[begin + rng.below(length)],
+                                          data_vec[begin + rng.below(length)]);
+                        }
+                    }};
+
+    if (!pool || blocks < 2)
+    {
+        for (std::size_t block{}; block < blocks; ++block)
+            fill_block(block);
+
+        return;
+    }
+
+    // A few tasks per thread balance the load without a task per block
+    auto tasks{std::min(blocks, 4 * (pool->size() + 1))};
+
+    pool->parallel_for(tasks,
+                       [&](std::size_t task)
+                       {
+                           for (auto block{task * blocks / tasks};
+                                block < (task + 1) * blocks / tasks; ++block)
+                               fill_block(block);
+                       });
+}
+
+#endif //! INPUT_GENERATOR_H
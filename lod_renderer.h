@@ -0,0 +1,425 @@
+/**
+ * @file lod_renderer.h
+ * @author Carlos Salguero
+ * @brief Level of detail rendering of arrays larger than the window
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef LOD_RENDERER_H
+#define LOD_RENDERER_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+// Operation log
+#include "operation_log.h"
+
+/**
+ * @brief
+ * Draws an array of any size, one pixel column per group of elements.
+ * Each column keeps the minimum, maximum and sum of the elements it covers
+ * and shows them as layers of its bar: white where every element reaches,
+ * light gray up to the mean and dark gray up to the furthest element.
+ * Operations update the aggregates in constant time and mark their columns
+ * dirty; only dirty columns are painted again, into a CPU pixel buffer that
+ * is uploaded to a streaming texture through SDL_LockTexture. Bars grow
+ * from the bottom to the row of their value, as in bar_renderer.
+ */
+class lod_renderer
+{
+public:
+    /**
+     * @brief
+     * Construct a new level of detail renderer, sized to the current
+     * viewport of the renderer.
+     * @param renderer Renderer where the render happens
+     * @param data_vec Data to be drawn
+     */
+    lod_renderer(SDL_Renderer *renderer, const std::vector<int> &data_vec)
+        : renderer{renderer}
+    {
+        resize(data_vec);
+    }
+
+    lod_renderer(const lod_renderer &) = delete;
+    lod_renderer &operator=(const lod_renderer &) = delete;
+
+    ~lod_renderer()
+    {
+        if (texture)
+            SDL_DestroyTexture(texture);
+    }
+
+    /**
+     * @brief
+     * Rebuilds the columns and the texture for the size of the current
+     * viewport. Called at construction and whenever the window is resized.
+     * @param data_vec Data to be drawn
+     */
+    void resize(const std::vector<int> &data_vec)
+    {
+        SDL_Rect viewport;
+
+        SDL_RenderGetViewport(renderer, &viewport);
+
+        element_count = data_vec.size();
+        width = static_cast<std::size_t>(std::max(
+            std::min<std::size_t>(static_cast<std::size_t>(viewport.w),
+                                  element_count),
+            std::size_t{1}));
+        height = std::max(viewport.h, 1);
+
+        if (texture)
+            SDL_DestroyTexture(texture);
+
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                    SDL_TEXTUREACCESS_STREAMING,
+                                    static_cast<int>(width), height);
+
+        pixels.assign(width * static_cast<std::size_t>(height), background);
+
+        lowest = std::numeric_limits<int>::max();
+        highest = std::numeric_limits<int>::min();
+
+        for (auto value : data_vec)
+        {
+            lowest = std::min(lowest, value);
+            highest = std::max(highest, value);
+        }
+
+        columns.assign(width, {});
+        dirty_columns.clear();
+        stale_columns.clear();
+
+        for (std::size_t column{}; column < width; ++column)
+        {
+            auto &bucket{columns[column]};
+
+            bucket.begin = column_begin(column);
+            bucket.end = column_begin(column + 1);
+
+            recompute(bucket, data_vec);
+            mark_dirty(column);
+        }
+    }
+
+    /**
+     * @brief
+     * Applies an operation of a log to the data, updating the aggregates of
+     * the columns it touches.
+     * @param data_vec Data being drawn
+     * @param op Operation to be applied
+     */
+    void apply(std::vector<int> &data_vec, const operation &op)
+    {
+        switch (op.kind)
+        {
+        case operation_kind::compare:
+            break;
+
+        case operation_kind::swap:
+            // A swap inside a column leaves its aggregates unchanged
+            if (column_of(op.first) != column_of(op.second))
+            {
+                replace(op.first, data_vec[op.first], data_vec[op.second]);
+                replace(op.second, data_vec[op.second], data_vec[op.first]);
+            }
+
+            std::swap(data_vec[op.first], data_vec[op.second]);
+            break;
+
+        case operation_kind::write:
+            replace(op.first, data_vec[op.first],
+                    static_cast<int>(op.second));
+            data_vec[op.first] = static_cast<int>(op.second);
+            break;
+        }
+    }
+
+    /**
+     * @brief
+     * Draws the data into the current render target. Does not present.
+     * @param data_vec Data being drawn
+     * @param red Index of the element drawn in red
+     * @param blue Index of the element drawn in blue
+     */
+    void draw(const std::vector<int> &data_vec, std::size_t red,
+              std::size_t blue)
+    {
+        // Columns whose extreme was overwritten are rescanned, within a
+        // budget per frame so huge columns cannot stall the playback
+        std::size_t budget{rescan_budget};
+
+        while (!stale_columns.empty() && budget > 0)
+        {
+            auto column{stale_columns.back()};
+            auto &bucket{columns[column]};
+
+            stale_columns.pop_back();
+            bucket.stale = false;
+
+            recompute(bucket, data_vec);
+            mark_dirty(column);
+
+            budget -= std::min(budget, bucket.end - bucket.begin);
+        }
+
+        upload();
+
+        SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+
+        highlight(red, 255, 0, 0);
+        highlight(blue, 0, 0, 255);
+    }
+
+    /**
+     * @brief
+     * Forces every column to be painted again on the next frame.
+     */
+    void invalidate()
+    {
+        for (std::size_t column{}; column < width; ++column)
+            mark_dirty(column);
+    }
+
+private:
+    /**
+     * @brief
+     * Aggregates of the elements covered by a pixel column.
+     */
+    struct bucket
+    {
+        std::size_t begin{};
+        std::size_t end{};
+        int min{};
+        int max{};
+        std::int64_t sum{};
+        bool dirty{false};
+        bool stale{false};
+    };
+
+    static constexpr std::uint32_t background{0xFF000000};
+    static constexpr std::uint32_t full{0xFFFFFFFF};
+    static constexpr std::uint32_t mean_layer{0xFFA0A0A0};
+    static constexpr std::uint32_t spread_layer{0xFF505050};
+    static constexpr std::size_t rescan_budget{1 << 22};
+
+    std::size_t column_of(std::size_t index) const
+    {
+        return index * width / element_count;
+    }
+
+    std::size_t column_begin(std::size_t column) const
+    {
+        return (column * element_count + width - 1) / width;
+    }
+
+    /**
+     * @brief
+     * Row of the window where the bar of a value starts.
+     * @param value Value of an element
+     * @return int Row, 0 being the top
+     */
+    int row_of(double value) const
+    {
+        if (highest == lowest)
+            return 0;
+
+        return static_cast<int>((value - lowest) * (height - 1) /
+                                (static_cast<double>(highest) - lowest));
+    }
+
+    /**
+     * @brief
+     * Recomputes the aggregates of a column from the data.
+     * @param column Column to be recomputed
+     * @param data_vec Data being drawn
+     */
+    void recompute(bucket &column, const std::vector<int> &data_vec) const
+    {
+        column.min = std::numeric_limits<int>::max();
+        column.max = std::numeric_limits<int>::min();
+        column.sum = 0;
+
+        for (auto index{column.begin}; index < column.end; ++index)
+        {
+            column.min = std::min(column.min, data_vec[index]);
+            column.max = std::max(column.max, data_vec[index]);
+            column.sum += data_vec[index];
+        }
+    }
+
+    /**
+     * @brief
+     * Updates the aggregates of the column of an element whose value
+     * changes. Losing the current minimum or maximum makes the column stale
+     * until it is rescanned.
+     * @param index Index of the element
+     * @param old_value Value before the change
+     * @param new_value Value after the change
+     */
+    void replace(std::size_t index, int old_value, int new_value)
+    {
+        auto column{column_of(index)};
+        auto &bucket{columns[column]};
+
+        bucket.sum += static_cast<std::int64_t>(new_value) - old_value;
+
+        bool lost_extreme{(old_value == bucket.min && new_value > old_value) ||
+                          (old_value == bucket.max && new_value < old_value)};
+
+        bucket.min = std::min(bucket.min, new_value);
+        bucket.max = std::max(bucket.max, new_value);
+
+        if (lost_extreme && !bucket.stale)
+        {
+            bucket.stale = true;
+            stale_columns.push_back(column);
+        }
+
+        mark_dirty(column);
+    }
+
+    void mark_dirty(std::size_t column)
+    {
+        if (columns[column].dirty)
+            return;
+
+        columns[column].dirty = true;
+        dirty_columns.push_back(column);
+    }
+
+    /**
+     * @brief
+     * Paints the dirty columns into the pixel buffer and uploads the span
+     * of the texture that covers them.
+     */
+    void upload()
+    {
+        if (dirty_columns.empty() || !texture)
+            return;
+
+        std::size_t first{width};
+        std::size_t last{};
+
+        for (auto column : dirty_columns)
+        {
+            paint(column);
+
+            columns[column].dirty = false;
+            first = std::min(first, column);
+            last = std::max(last, column);
+        }
+
+        dirty_columns.clear();
+
+        // Locked pixels are write only: the whole span is copied back
+        SDL_Rect span{static_cast<int>(first), 0,
+                      static_cast<int>(last - first + 1), height};
+        void *locked;
+        int pitch;
+
+        if (SDL_LockTexture(texture, &span, &locked, &pitch) != 0)
+            return;
+
+        for (int row{}; row < height; ++row)
+            std::memcpy(static_cast<std::byte *>(locked) +
+                            static_cast<std::size_t>(row) * pitch,
+                        pixels.data() + row * width + first,
+                        (last - first + 1) * sizeof(std::uint32_t));
+
+        SDL_UnlockTexture(texture);
+    }
+
+    /**
+     * @brief
+     * Paints the layers of a column into the pixel buffer.
+     * @param column Column to be painted
+     */
+    void paint(std::size_t column)
+    {
+        const auto &bucket{columns[column]};
+        auto count{bucket.end - bucket.begin};
+
+        if (count == 0)
+            return;
+
+        int spread{row_of(bucket.min)};
+        int mean{row_of(static_cast<double>(bucket.sum) /
+                        static_cast<double>(count))};
+        int solid{row_of(bucket.max)};
+
+        for (int row{}; row < height; ++row)
+        {
+            std::uint32_t color{background};
+
+            if (row >= solid)
+                color = full;
+
+            else if (row >= mean)
+                color = mean_layer;
+
+            else if (row >= spread)
+                color = spread_layer;
+
+            pixels[row * width + column] = color;
+        }
+    }
+
+    /**
+     * @brief
+     * Draws the bar of one element in a color, over the texture.
+     * @param index Index of the element, or past the end for none
+     * @param r Red component
+     * @param g Green component
+     * @param b Blue component
+     */
+    void highlight(std::size_t index, std::uint8_t r, std::uint8_t g,
+                   std::uint8_t b)
+    {
+        if (index >= element_count)
+            return;
+
+        SDL_Rect viewport;
+
+        SDL_RenderGetViewport(renderer, &viewport);
+
+        auto column{column_of(index)};
+        int x{static_cast<int>(column * viewport.w / width)};
+        int top{row_of(columns[column].min)};
+
+        SDL_Rect bar{x, top, std::max(viewport.w / static_cast<int>(width), 1),
+                     height - top};
+
+        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+        SDL_RenderFillRect(renderer, &bar);
+    }
+
+    SDL_Renderer *renderer;
+    SDL_Texture *texture{nullptr};
+
+    std::size_t element_count{};
+    std::size_t width{};
+    int height{};
+    int lowest{};
+    int highest{};
+
+    std::vector<bucket> columns;
+    std::vector<std::size_t> dirty_columns;
+    std::vector<std::size_t> stale_columns;
+    std::vector<std::uint32_t> pixels;
+};
+
+#endif //! LOD_RENDERER_H
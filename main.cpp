@@ -13,25 +13,137 @@
 #include <random>
 #include <ranges>
 #include <algorithm>
-#include <limits>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <latch>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
 
 // SDL library
 #include <SDL2/SDL.h>
 
 // Sorts
 #include "sorts.h"
+#include "radix_sort.h"
+#include "operation_log.h"
+#include "operation_stream.h"
+#include "player.h"
+#include "race.h"
+#include "trace_file.h"
+#include "external_sort.h"
+
+// Inputs
+#include "input_generator.h"
+#include "thread_pool.h"
+
+// Instrumentation
+#include "perf_counters.h"
+#include "profiler.h"
+#include "text_overlay.h"
+
+// Largest array the quadratic sorts are run on
+constexpr std::size_t quadratic_limit{10'000};
+
+// Largest array printed to the terminal
+constexpr std::size_t printed_elements{1'000};
+
+// Operations buffered between the sort thread and the render thread
+constexpr std::size_t stream_capacity{1 << 16};
+
+// Menu options past the algorithms: quit, pick the algorithms of a race
+// and start it
+constexpr int quit_option{15};
+constexpr int race_option{16};
+constexpr int start_option{17};
+
+/**
+ * @brief
+ * A sort running on the worker thread. The timed and counted runs are
+ * published before the operations start streaming through the queue.
+ */
+struct sort_session
+{
+    operation_queue queue{stream_capacity};
+    double elapsed_ms{};
+    std::uint64_t operations{};
+    perf_report report;
+    std::atomic<bool> measured{false};
+};
 
 // Function prototypes
 void menu();
-int validate_input(int);
+std::vector<std::string> menu_lines(bool = false,
+                                    const std::vector<int> & = {});
+std::string option_name(int);
+int menu_option(const SDL_Keysym &);
+bool allowed(int, std::size_t);
+void draw_idle(SDL_Renderer *, text_overlay &);
+void sort_worker(std::stop_token, const std::vector<int> &, int,
+                 const std::string &, sort_session &);
+bool run_race(const std::vector<int> &, const std::vector<int> &,
+              SDL_Renderer *, const playback_pacing &);
+void race_worker(std::stop_token, const std::vector<int> &, race_lane &,
+                 unsigned int, std::latch &);
+bool run_external(const std::string &, std::size_t, SDL_Renderer *,
+                  text_overlay &);
+std::vector<std::string> external_lines(const std::string &,
+                                        const external_progress &,
+                                        std::size_t, double);
+std::vector<std::string> counter_lines(const perf_report &);
+std::string format_count(double);
+
+template <typename Recorder>
+void run_sort(int, std::span<int>, Recorder &);
+
+template <typename Compare, typename Recorder>
+void run_sort(int, std::span<int>, Compare, Recorder &);
+
+bool parse_options(int, char **, playback_pacing &, std::size_t &,
+                   input_spec &, std::string &, std::string &, std::string &,
+                   std::size_t &, std::string &);
+void write_profile(const std::string &);
 void end_program();
 
 // Main function
 int main(int argc, char **argv)
 {
-    // Unused argc, argv
-    (void)argc;
-    (void)argv;
+    playback_pacing pacing;
+    std::size_t element_count{100};
+    std::string record_path;
+    std::string replay_path;
+    std::string external_path;
+    std::size_t memory_limit{external_sort_options{}.memory_limit};
+    std::string profile_path;
+
+    // A single draw from the system entropy, so a run can be repeated with
+    // the seed it prints
+    input_spec input{input_distribution::uniform, std::random_device{}()};
+
+    if (!parse_options(argc, argv, pacing, element_count, input, record_path,
+                       replay_path, external_path, memory_limit, profile_path))
+    {
+        std::cout << "Usage: SortVisualizer [--duration SECONDS | --rate OPS] "
+                     "[--elements N] [--distribution NAME] [--seed N] "
+                     "[--record FILE] [--replay FILE] "
+                     "[--external FILE [--memory MB]] [--profile FILE]"
+                  << std::endl;
+        std::cout << "Distributions:";
+
+        for (auto distribution : input_distributions)
+            std::cout << " " << distribution_name(distribution);
+
+        std::cout << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    PROFILE_THREAD("render");
 
     if (SDL_Init(SDL_INIT_EVERYTHING) < 0)
     {
@@ -48,7 +160,7 @@ int main(int argc, char **argv)
     SDL_Window *window{SDL_CreateWindow("Sorting Algorithm Visualizer",
                                         SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
                                         window_width, window_height,
-                                        0)};
+                                        SDL_WINDOW_RESIZABLE)};
 
     if (!window)
     {
@@ -71,118 +183,195 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
 
-    SDL_RenderSetScale(renderer, 5, 5);
+    // Values run from 1 so that every bar shows
+    input.low = 1;
+    input.high = static_cast<int>(std::max<std::size_t>(99, element_count - 1));
 
-    std::random_device rng;
-    std::uniform_int_distribution d(1, 99);
+    std::vector<int> data_vec(element_count);
 
-    std::vector<int> data_vec;
+    {
+        work_stealing_pool pool;
 
-    // Filling the data
-    for (int i{}; i < 100; ++i)
-        data_vec.push_back(d(rng));
+        generate_input(data_vec, input, &pool);
+    }
 
-    std::vector<int> desorganized_data{data_vec};
+    std::cout << "Input: " << distribution_name(input.distribution)
+              << ", seed " << input.seed << std::endl;
 
     // Output (desorganized)
-    std::cout << "Generated vector: " << std::endl;
+    if (data_vec.size() <= printed_elements)
+    {
+        std::cout << "Generated vector: " << std::endl;
 
-    for (auto i : data_vec)
-        std::cout << i << " ";
+        for (auto i : data_vec)
+            std::cout << i << " ";
 
-    std::cout << std::endl;
+        std::cout << std::endl;
+    }
 
     // Sorting
     bool running{true};
+    text_overlay overlay;
+
+    // Algorithms picked for a race, while picking
+    std::vector<int> racers;
+    bool picking{false};
+
+    // A file given on the command line is sorted out of core before the
+    // menu
+    if (!external_path.empty())
+        running = run_external(external_path, memory_limit, renderer, overlay);
+
+    // A trace given on the command line is played before the menu
+    if (running && !replay_path.empty())
+    {
+        try
+        {
+            trace_reader trace{replay_path};
+
+            std::cout << "Replaying " << replay_path << " ("
+                      << trace.operations() << " operations)" << std::endl;
+
+            overlay.set_lines({"replay of " + replay_path,
+                               "home, page up/down, left arrow: seek"});
+            running = play(trace, renderer, &overlay, pacing);
+        }
+
+        catch (const std::exception &error)
+        {
+            std::cout << "Error: " << error.what() << std::endl;
+        }
+    }
+
+    menu();
+    overlay.set_lines(menu_lines());
+    draw_idle(renderer, overlay);
 
     while (running)
     {
         SDL_Event event;
+        int option{};
 
-        while (SDL_PollEvent(&event))
+        // The menu is read from the keyboard of the window, so the event
+        // loop never blocks on the terminal
+        if (!SDL_WaitEventTimeout(&event, 100))
+            continue;
+
+        do
         {
             if (event.type == SDL_QUIT)
-            {
-                running = false;
-                break;
-            }
-        }
+                option = quit_option;
 
-        menu();
+            else if (event.type == SDL_WINDOWEVENT)
+                draw_idle(renderer, overlay);
 
-        std::cout << "Choose the algorithm you wish to see: ";
-        int option{validate_input(option)};
+            else if (event.type == SDL_KEYDOWN && !option)
+                option = menu_option(event.key.keysym);
+        } while (SDL_PollEvent(&event));
 
-        switch (option)
+        if (option == quit_option)
         {
-        case 1:
-            bubble_sort_ascending(data_vec, renderer);
-            data_vec = desorganized_data;
-
+            std::cout << "Closign application" << std::endl;
+            running = false;
             break;
+        }
 
-        case 2:
-            bubble_sort_descending(data_vec, renderer);
-            data_vec = desorganized_data;
+        if (!option)
+            continue;
 
-            break;
+        if (option == race_option)
+        {
+            picking = !picking;
+            racers.clear();
 
-        case 3:
-            selection_sort_ascending(data_vec, renderer);
-            data_vec = desorganized_data;
+            overlay.set_lines(menu_lines(picking, racers));
+            draw_idle(renderer, overlay);
 
-            break;
+            continue;
+        }
 
-        case 4:
-            selection_sort_descending(data_vec, renderer);
-            data_vec = desorganized_data;
+        if (picking)
+        {
+            if (option == start_option && !racers.empty())
+            {
+                picking = false;
+                running = run_race(data_vec, racers, renderer, pacing);
+                racers.clear();
+                overlay.set_lines(menu_lines());
 
-            break;
+                if (running)
+                    menu();
 
-        case 5:
-            insertion_sort_ascending(data_vec, renderer);
-            data_vec = desorganized_data;
+                continue;
+            }
 
-            break;
+            // While picking, algorithms join or leave the race
+            if (option < quit_option && allowed(option, data_vec.size()))
+            {
+                auto found{std::ranges::find(racers, option)};
 
-        case 6:
-            insertion_sort_descending(data_vec, renderer);
-            data_vec = desorganized_data;
+                if (found == racers.end())
+                    racers.push_back(option);
 
-            break;
+                else
+                    racers.erase(found);
+            }
 
-        case 7:
-            quick_sort_ascending(data_vec, renderer);
-            (std::ranges::is_sorted(data_vec))
-                ? std::cout << "Sorted" << std::endl
-                : std::cout << "Not sorted" << std::endl;
+            overlay.set_lines(menu_lines(picking, racers));
+            draw_idle(renderer, overlay);
 
-            data_vec = desorganized_data;
+            continue;
+        }
 
-            break;
+        if (option == start_option || !allowed(option, data_vec.size()))
+            continue;
 
-        case 8:
-            data_vec = desorganized_data;
+        // The sort runs on its own thread and streams its operations; the
+        // render thread animates them from the original data as they come.
+        // Leaving the scope stops the worker and joins it.
+        sort_session session;
+        std::jthread worker{sort_worker, std::cref(data_vec), option,
+                            std::cref(record_path), std::ref(session)};
 
-            break;
+        overlay.set_lines({"sorting..."});
 
-        case 9:
-            data_vec = desorganized_data;
+        while (running && !session.measured.load(std::memory_order_acquire))
+        {
+            while (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    running = false;
+            }
 
-            break;
+            draw_idle(renderer, overlay);
+            SDL_Delay(16);
+        }
 
-        case 10:
-            data_vec = desorganized_data;
+        if (running && session.operations)
+        {
+            std::cout << "Sorted in " << session.elapsed_ms << " ms ("
+                      << session.operations << " operations)" << std::endl;
 
-            break;
+            auto lines{counter_lines(session.report)};
 
-        case 11:
-            std::cout << "Closign application" << std::endl;
-            running = false;
-            break;
+            for (const auto &line : lines)
+                std::cout << line << std::endl;
+
+            overlay.set_lines(std::move(lines));
+
+            running = play(session.queue, session.operations, data_vec,
+                           renderer, &overlay, pacing);
         }
+
+        overlay.set_lines(menu_lines());
+
+        if (running)
+            menu();
     }
 
+    if (!profile_path.empty())
+        write_profile(profile_path);
+
     end_program();
 }
 
@@ -195,38 +384,744 @@ void menu()
 {
     std::cout << "---- Sorting Algorithms Visualizer ----" << std::endl;
 
-    std::cout << "1. Bubble Sort (Ascending) Algorithm "
-              << "\n2. Bubble Sort (Descending) Algorithm "
-              << "\n3. Selection Sort (Ascending) Algorithm"
-              << "\n4. Selection Sort (Descending) Algorithm"
-              << "\n5. Insertion Sort (Ascending) Algorithm"
-              << "\n6. Insertion Sort (Descending) Algorithm"
-              << "\n7. Quick Sort (Ascending) Algorithm"
-              << "\n8. Quick Sort (Descending) Algorithm"
-              << "\n9. Merge Sort (Ascending) Algorithm"
-              << "\n10. Merge Sort (Descending) Algorithm"
-              << "\n11. Quit Application" << std::endl;
+    for (const auto &line : menu_lines())
+        std::cout << line << std::endl;
+
+    std::cout << "(Playback: space pauses, right arrow steps, up/down arrows "
+                 "change the speed)"
+              << std::endl;
+}
+
+/**
+ * @brief
+ * Lines of the menu, shown in the terminal and over the window. Options
+ * are chosen with the keyboard of the window.
+ * @param picking Whether the algorithms of a race are being picked
+ * @param racers Options picked for the race
+ * @return std::vector<std::string> Lines of the menu
+ */
+std::vector<std::string> menu_lines(bool picking,
+                                    const std::vector<int> &racers)
+{
+    std::vector<std::string> lines{"1. Bubble Sort",
+                                   "2. Selection Sort",
+                                   "3. Insertion Sort",
+                                   "4. Quick Sort",
+                                   "5. Merge Sort",
+                                   "6. Radix Sort",
+                                   "7. Hybrid Sort",
+                                   "Shift + number: descending order",
+                                   "R. Race several algorithms",
+                                   "Q. Quit Application"};
+
+    if (!picking)
+        return lines;
+
+    lines.push_back("");
+    lines.push_back("Race: numbers pick, Return starts, R cancels");
+
+    for (auto option : racers)
+        lines.push_back("  " + option_name(option));
+
+    return lines;
+}
+
+/**
+ * @brief
+ * Name of the algorithm and order of a menu option.
+ * @param option Option of the menu
+ * @return std::string Name of the option
+ */
+std::string option_name(int option)
+{
+    static constexpr const char *names[]{"Bubble", "Selection", "Insertion",
+                                         "Quick",  "Merge",     "Radix",
+                                         "Hybrid"};
+
+    return std::string{names[(option - 1) / 2]} +
+           (option % 2 ? " ascending" : " descending");
+}
+
+/**
+ * @brief
+ * Turns a key press into an option of the menu: the algorithm keys give
+ * the odd (ascending) options, or the even (descending) ones with shift.
+ * @param key Key pressed
+ * @return int Option of the menu, or 0 for keys outside the menu
+ */
+int menu_option(const SDL_Keysym &key)
+{
+    if (key.sym == SDLK_q || key.sym == SDLK_ESCAPE)
+        return quit_option;
+
+    if (key.sym == SDLK_r)
+        return race_option;
+
+    if (key.sym == SDLK_RETURN)
+        return start_option;
+
+    if (key.sym < SDLK_1 || key.sym > SDLK_7)
+        return 0;
+
+    int algorithm{static_cast<int>(key.sym - SDLK_1)};
+
+    return 2 * algorithm + (key.mod & KMOD_SHIFT ? 2 : 1);
+}
+
+/**
+ * @brief
+ * Whether an option can run on the data. Options 1 to 8 are the quadratic
+ * sorts, refused on large arrays: quick sort partitions around the last
+ * element, so sorted, reversed or repeated keys make it quadratic and
+ * recurse as deep as the array is long.
+ * @param option Option of the menu
+ * @param size Number of elements
+ * @return true The option can run
+ * @return false The array is too large for the option
+ */
+bool allowed(int option, std::size_t size)
+{
+    if (option > 8 || size <= quadratic_limit)
+        return true;
+
+    std::cout << "Bubble, selection, insertion and quick sort are limited to "
+              << quadratic_limit << " elements" << std::endl;
+
+    return false;
+}
+
+/**
+ * @brief
+ * Draws the window while no sort is played: the overlay over a blank
+ * background.
+ * @param renderer Renderer where the render happens
+ * @param overlay Text of the window
+ */
+void draw_idle(SDL_Renderer *renderer, text_overlay &overlay)
+{
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+
+    overlay.draw(renderer);
+
+    SDL_RenderPresent(renderer);
+}
+
+/**
+ * @brief
+ * Body of the worker thread. The sort is run from the same data timed
+ * without a recorder, counted, recorded into a trace file when one was
+ * asked for, under the hardware counters, and finally streaming its
+ * operations to the render thread, which sets its pace.
+ * @param stop Requested when the render thread stops playing
+ * @param data_vec Data to be sorted, left untouched
+ * @param option Option of the menu
+ * @param trace_path Trace file of the run, or empty
+ * @param session Results of the runs and queue of the operations
+ */
+void sort_worker(std::stop_token stop, const std::vector<int> &data_vec,
+                 int option, const std::string &trace_path,
+                 sort_session &session)
+{
+    PROFILE_THREAD("sort worker");
+
+    std::vector<int> timed{data_vec};
+    null_recorder bare;
+    auto start{std::chrono::steady_clock::now()};
+
+    {
+        PROFILE_ZONE("timed sort");
+        run_sort(option, timed, bare);
+    }
+
+    auto elapsed{std::chrono::steady_clock::now() - start};
+
+    session.elapsed_ms =
+        std::chrono::duration<double, std::milli>(elapsed).count();
+
+    // Counted apart, so the time above is the bare sort
+    std::vector<int> counted{data_vec};
+    operation_counter counter;
+
+    {
+        PROFILE_ZONE("counted sort");
+        run_sort(option, counted, counter);
+    }
+
+    session.operations = counter.comparisons + counter.swaps + counter.writes;
+
+    if (!trace_path.empty())
+    {
+        try
+        {
+            PROFILE_ZONE("recorded sort");
+
+            std::vector<int> recorded{data_vec};
+            trace_writer trace{trace_path, data_vec};
+
+            run_sort(option, recorded, trace);
+            trace.finish();
+
+            std::cout << "Trace written to " << trace_path << std::endl;
+        }
+
+        catch (const std::exception &error)
+        {
+            std::cout << "Error: " << error.what() << std::endl;
+        }
+    }
+
+    // Counters only count the thread that opens them
+    perf_counters counters;
+    std::vector<int> measured{data_vec};
+    perf_recorder perf{counters};
+
+    {
+        PROFILE_ZONE("measured sort");
+
+        perf.start();
+        run_sort(option, measured, perf);
+        perf.stop();
+    }
+
+    session.report = perf.report();
+    session.measured.store(true, std::memory_order_release);
+
+    std::vector<int> streamed{data_vec};
+    stream_recorder recorder{session.queue, stop};
+
+    // Includes the time the sort waits for the player to drain the queue
+    PROFILE_ZONE("streamed sort");
+    run_sort(option, streamed, recorder);
+}
+
+/**
+ * @brief
+ * Races several algorithms over copies of the same data, each on its own
+ * thread pinned to its own core, released together. The live counters are
+ * shown while they race, then the race is replayed side by side.
+ * @param data_vec Data to be sorted, left untouched
+ * @param options Options of the menu taking part
+ * @param renderer Renderer where the render happens
+ * @param pacing Target duration or rate of the replay
+ * @return true The race was watched to the end
+ * @return false The window was closed
+ */
+bool run_race(const std::vector<int> &data_vec,
+              const std::vector<int> &options, SDL_Renderer *renderer,
+              const playback_pacing &pacing)
+{
+    race_lanes lanes;
+
+    for (auto option : options)
+        lanes.push_back(std::make_unique<race_lane>(option,
+                                                    option_name(option)));
+
+    // Core 0 is left to the render thread when there are cores to spare
+    unsigned int cores{std::max(std::thread::hardware_concurrency(), 1u)};
+    unsigned int first_core{lanes.size() < cores ? 1u : 0u};
+
+    std::latch start{static_cast<std::ptrdiff_t>(lanes.size()) + 1};
+
+    // Declared after the lanes, so the racers are joined before the lanes
+    // they write to are destroyed
+    std::vector<std::jthread> racers;
+
+    for (std::size_t index{}; index < lanes.size(); ++index)
+        racers.emplace_back(race_worker, std::cref(data_vec),
+                            std::ref(*lanes[index]),
+                            first_core + static_cast<unsigned int>(index),
+                            std::ref(start));
+
+    start.arrive_and_wait();
+
+    if (!watch_race(lanes, renderer, std::chrono::steady_clock::now()))
+        return false;
+
+    std::cout << "---- Race ----" << std::endl;
+
+    for (const auto &lane : lanes)
+        std::cout << lane->name << ": "
+                  << lane->elapsed_ns.load(std::memory_order_relaxed) / 1e6
+                  << " ms (" << lane->comparisons << " comparisons, "
+                  << lane->swaps << " swaps, " << lane->writes << " writes)"
+                  << std::endl;
+
+    return play_race(lanes, data_vec, renderer, pacing);
+}
+
+/**
+ * @brief
+ * Body of a racer thread. The racer pins itself, copies the data into
+ * memory of its own, waits for every other racer, and sorts while
+ * publishing its counters. It then sorts the data again, streaming the
+ * operations of the replay.
+ * @param stop Requested when the render thread stops playing
+ * @param data_vec Data to be sorted, left untouched
+ * @param lane Lane of the racer
+ * @param core Core the racer is pinned to
+ * @param start Releases every racer at once
+ */
+void race_worker(std::stop_token stop, const std::vector<int> &data_vec,
+                 race_lane &lane, unsigned int core, std::latch &start)
+{
+    pin_to_core(core);
+    PROFILE_THREAD(lane.name);
+
+    // First touched here, so the copy is local to the core of the racer
+    lane.data = {lane.memory.get<int>(data_vec.size()), data_vec.size()};
+    std::ranges::copy(data_vec, lane.data.begin());
+
+    race_recorder counter{lane};
+
+    start.arrive_and_wait();
+
+    auto begin{std::chrono::steady_clock::now()};
+
+    {
+        PROFILE_ZONE("raced sort");
+        run_sort(lane.option, lane.data, counter);
+    }
+
+    auto elapsed{std::chrono::steady_clock::now() - begin};
+
+    lane.elapsed_ns.store(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    lane.finished.store(true, std::memory_order_release);
+
+    std::ranges::copy(data_vec, lane.data.begin());
+
+    stream_recorder recorder{lane.queue, stop};
+
+    PROFILE_ZONE("streamed sort");
+    run_sort(lane.option, lane.data, recorder);
+}
+
+/**
+ * @brief
+ * Runs the sort of a menu option. Odd options sort in ascending order,
+ * even options in descending order.
+ * @tparam Recorder Null recorder, operation log, counter or perf recorder
+ * @param option Option of the menu
+ * @param data_vec Vector with data to be sorted
+ * @param recorder Receives the operations of the sort
+ */
+template <typename Recorder>
+void run_sort(int option, std::span<int> data_vec, Recorder &recorder)
+{
+    if (option % 2)
+        run_sort(option, data_vec, std::ranges::less{}, recorder);
+
+    else
+        run_sort(option, data_vec, std::ranges::greater{}, recorder);
+}
+
+/**
+ * @brief
+ * Runs the algorithm of a menu option in a given order.
+ * @tparam Compare std::ranges::less or std::ranges::greater
+ * @tparam Recorder Null recorder, operation log, counter or perf recorder
+ * @param option Option of the menu
+ * @param data_vec Vector with data to be sorted
+ * @param compare Ordering of the sort
+ * @param recorder Receives the operations of the sort
+ */
+template <typename Compare, typename Recorder>
+void run_sort(int option, std::span<int> data_vec, Compare compare,
+              Recorder &recorder)
+{
+    switch ((option + 1) / 2)
+    {
+    case 1:
+        bubble_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 2:
+        selection_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 3:
+        insertion_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 4:
+        quick_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 5:
+        merge_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 6:
+        msd_radix_sort(data_vec, compare, {}, recorder);
+        break;
+
+    case 7:
+        hybrid_sort(data_vec, compare, {}, recorder);
+        break;
+    }
+}
+
+/**
+ * @brief
+ * Sorts the int32 keys of a file out of core into FILE.sorted, on a
+ * worker thread, while the window shows the progress of the current phase.
+ * Closing the window stops the sort.
+ * @param path File sorted
+ * @param memory_limit Bytes the buffers of the sort may take
+ * @param renderer Renderer where the render happens
+ * @param overlay Text of the window
+ * @return true The sort ended, sorted or with an error
+ * @return false The window was closed
+ */
+bool run_external(const std::string &path, std::size_t memory_limit,
+                  SDL_Renderer *renderer, text_overlay &overlay)
+{
+    external_progress progress;
+    std::string error;
+    auto start{std::chrono::steady_clock::now()};
+
+    // Leaving the scope stops the sort and joins it
+    std::jthread worker{
+        [&](std::stop_token stop)
+        {
+            PROFILE_THREAD("external sort");
+
+            try
+            {
+                PROFILE_ZONE("external sort");
+
+                external_sort<int>(path, path + ".sorted", {memory_limit, {}},
+                                   std::less<int>{}, shared_pool(),
+                                   &progress, stop);
+            }
+
+            catch (const std::exception &exception)
+            {
+                error = exception.what();
+            }
+
+            progress.phase.store(external_phase::done,
+                                 std::memory_order_release);
+        }};
+
+    double seconds{};
+
+    while (progress.phase.load(std::memory_order_acquire) !=
+           external_phase::done)
+    {
+        SDL_Event event;
+
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_QUIT)
+                return false;
+        }
+
+        seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+        auto keys{progress.keys.load(std::memory_order_relaxed)};
+        double share{keys ? static_cast<double>(progress.done.load(
+                                std::memory_order_relaxed)) /
+                                keys
+                          : 0.0};
+
+        int width, height;
+        SDL_GetRendererOutputSize(renderer, &width, &height);
+
+        SDL_Rect frame{width / 10, height / 2, width * 8 / 10, height / 20};
+        SDL_Rect filled{frame.x, frame.y,
+                        static_cast<int>(frame.w * std::min(share, 1.0)),
+                        frame.h};
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        overlay.set_lines(external_lines(path, progress, memory_limit,
+                                         seconds));
+        overlay.draw(renderer);
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderFillRect(renderer, &filled);
+        SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
+        SDL_RenderDrawRect(renderer, &frame);
+
+        SDL_RenderPresent(renderer);
+        SDL_Delay(16);
+    }
+
+    if (!error.empty())
+        std::cout << "Error: " << error << std::endl;
+
+    else
+        std::cout << "Sorted " << progress.keys.load() << " keys of " << path
+                  << " into " << path << ".sorted in " << seconds << " s ("
+                  << progress.runs.load() << " runs, "
+                  << progress.passes.load() << " merge passes)" << std::endl;
+
+    return true;
+}
+
+/**
+ * @brief
+ * Describes the progress of an external sort.
+ * @param path File sorted
+ * @param progress Progress of the sort
+ * @param memory_limit Bytes the buffers of the sort may take
+ * @param seconds Time elapsed since the sort started
+ * @return std::vector<std::string> Lines of the description
+ */
+std::vector<std::string> external_lines(const std::string &path,
+                                        const external_progress &progress,
+                                        std::size_t memory_limit,
+                                        double seconds)
+{
+    auto keys{format_count(static_cast<double>(progress.keys.load()))};
+    auto done{format_count(static_cast<double>(progress.done.load()))};
+    auto runs{format_count(static_cast<double>(progress.runs.load()))};
+
+    char status[96];
+    char memory[64];
+
+    if (progress.phase.load() == external_phase::runs)
+        std::snprintf(status, sizeof(status), "runs: %s sorted, %s of %s keys",
+                      runs.c_str(), done.c_str(), keys.c_str());
+
+    else
+        std::snprintf(status, sizeof(status),
+                      "merge pass %u of %u: %s of %s keys",
+                      progress.pass.load(), progress.passes.load(),
+                      done.c_str(), keys.c_str());
+
+    std::snprintf(memory, sizeof(memory), "memory cap %zu MB, %.1f s",
+                  memory_limit >> 20, seconds);
+
+    return {"external sort of " + path, status, memory};
+}
+
+/**
+ * @brief
+ * Describes the counters of a run: wall time, IPC, every event and the
+ * share of each phase. Events the machine cannot count are shown as n/a.
+ * @param report Counters of the run
+ * @return std::vector<std::string> Lines of the description
+ */
+std::vector<std::string> counter_lines(const perf_report &report)
+{
+    const auto &total{report.total};
+
+    auto event{[&](std::size_t index)
+               {
+                   return total.available[index]
+                              ? format_count(static_cast<double>(
+                                    total.values[index]))
+                              : std::string{"n/a"};
+               }};
+
+    // Instructions and cycles are the first two events
+    bool cycles{total.available[1] && total.values[1] > 0};
+    char ipc[16]{"n/a"};
+    char wall[64];
+
+    if (cycles && total.available[0])
+        std::snprintf(ipc, sizeof(ipc), "%.2f",
+                      static_cast<double>(total.values[0]) / total.values[1]);
+
+    std::snprintf(wall, sizeof(wall), "wall %.3f ms  ipc %s",
+                  total.wall_ns / 1e6, ipc);
+
+    std::vector<std::string> lines{
+        wall,
+        "instructions " + event(0) + "  cycles " + event(1),
+        "branch misses " + event(2) + "  l1d misses " + event(3),
+        "llc misses " + event(4) + "  dtlb misses " + event(5)};
+
+    for (std::size_t phase{}; phase < sort_phase_count; ++phase)
+    {
+        if (!report.phase_calls[phase])
+            continue;
+
+        const auto &sample{report.phases[phase]};
+
+        // Share of the cycles when they are counted, of the time otherwise
+        double share{cycles ? static_cast<double>(sample.values[1]) /
+                               total.values[1]
+                         : sample.wall_ns / std::max(total.wall_ns, 1.0)};
+
+        char line[96];
+
+        std::snprintf(line, sizeof(line), "%s x%s: %.0f%% of %s",
+                      phase_name(static_cast<sort_phase>(phase)),
+                      format_count(static_cast<double>(
+                                       report.phase_calls[phase]))
+                          .c_str(),
+                      100 * share, cycles ? "cycles" : "time");
+
+        lines.push_back(line);
+    }
+
+    return lines;
+}
+
+/**
+ * @brief
+ * Formats a count with a K, M or G suffix.
+ * @param value Count
+ * @return std::string Formatted count
+ */
+std::string format_count(double value)
+{
+    const char *suffix{""};
+
+    for (const char *next : {"K", "M", "G"})
+    {
+        if (value < 1000)
+            break;
+
+        value /= 1000;
+        suffix = next;
+    }
+
+    char text[32];
+
+    std::snprintf(text, sizeof(text), *suffix ? "%.2f%s" : "%.0f%s", value,
+                  suffix);
+
+    return text;
+}
+
+/**
+ * @brief
+ * Reads the command line: the pacing of the playback, as a target duration
+ * in seconds or a rate in operations per second, the number of elements
+ * to sort, their distribution and seed, the trace file every sort is
+ * recorded into, a trace file to play on start, a file to sort out of core
+ * on start with its memory cap, and the file the profiling zones are
+ * written to on exit.
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param pacing Pacing of the playback
+ * @param element_count Number of elements
+ * @param input Distribution and seed of the elements
+ * @param record_path Trace file written by every sort, or empty
+ * @param replay_path Trace file played on start, or empty
+ * @param external_path File sorted out of core on start, or empty
+ * @param memory_limit Memory cap in bytes of the external sort
+ * @param profile_path Chrome trace of the profiling zones, or empty
+ * @return true The command line is valid
+ * @return false The command line is invalid
+ */
+bool parse_options(int argc, char **argv, playback_pacing &pacing,
+                   std::size_t &element_count, input_spec &input,
+                   std::string &record_path, std::string &replay_path,
+                   std::string &external_path, std::size_t &memory_limit,
+                   std::string &profile_path)
+{
+    for (int i{1}; i + 1 < argc; i += 2)
+    {
+        std::string arg{argv[i]};
+
+        if (arg == "--record")
+        {
+            record_path = argv[i + 1];
+            continue;
+        }
+
+        if (arg == "--replay")
+        {
+            replay_path = argv[i + 1];
+            continue;
+        }
+
+        if (arg == "--external")
+        {
+            external_path = argv[i + 1];
+            continue;
+        }
+
+        if (arg == "--profile")
+        {
+            profile_path = argv[i + 1];
+            continue;
+        }
+
+        if (arg == "--distribution")
+        {
+            auto distribution{parse_distribution(argv[i + 1])};
+
+            if (!distribution)
+                return false;
+
+            input.distribution = *distribution;
+            continue;
+        }
+
+        if (arg == "--seed")
+        {
+            char *end;
+            input.seed = std::strtoull(argv[i + 1], &end, 10);
+
+            if (*end || end == argv[i + 1])
+                return false;
+
+            continue;
+        }
+
+        double value{std::atof(argv[i + 1])};
+
+        if (value <= 0)
+            return false;
+
+        if (arg == "--duration")
+            pacing.duration = value;
+
+        else if (arg == "--rate")
+            pacing.ops_per_second = value;
+
+        else if (arg == "--memory")
+            memory_limit = static_cast<std::size_t>(value * (1 << 20));
+
+        // Operation logs store indices in 32 bits
+        else if (arg == "--elements" && value >= 2 && value <= 1e9)
+            element_count = static_cast<std::size_t>(value);
+
+        else
+            return false;
+    }
+
+    return argc % 2 == 1;
 }
 
 /**
  * @brief
- * Validates the user input. If the input is correct, returns the value.
- * Otherwise, asks the user for another input.
- * @param input User input to be validated
- * @return int Input validated.
+ * Writes the profiling zones of every thread as a Chrome trace, to be
+ * opened in chrome://tracing or Perfetto.
+ * @param path Trace file
  */
-int validate_input(int input)
+void write_profile(const std::string &path)
 {
-    while (!(std::cin >> input))
+    if (!profiler_enabled)
+    {
+        std::cout << "Error: built without SORT_PROFILER, no profile written"
+                  << std::endl;
+
+        return;
+    }
+
+    try
     {
-        std::cin.clear();
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(),
-                        '\n');
+        profiler::instance().write_chrome_trace(path);
 
-        std::cout << "Invalid input. Try again: ";
+        std::cout << "Profile written to " << path << std::endl;
     }
 
-    return input;
+    catch (const std::exception &error)
+    {
+        std::cout << "Error: " << error.what() << std::endl;
+    }
 }
 
 /**
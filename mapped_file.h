@@ -0,0 +1,214 @@
+/**
+ * @file mapped_file.h
+ * @author Carlos Salguero
+ * @brief Memory mapped binary datasets of fixed-width keys
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief
+ * How a mapped file is opened.
+ */
+enum class map_mode
+{
+    read_only,
+    read_write,
+    create
+};
+
+/**
+ * @brief
+ * Access pattern hint given to the kernel for the next phase of a sort.
+ */
+enum class access_pattern
+{
+    normal,
+    sequential,
+    random
+};
+
+/**
+ * @brief
+ * A file mapped into memory. Sorting a dataset through the mapping avoids
+ * reading it into a buffer first: pages are faulted in straight from the
+ * page cache and, for writable mappings, written back by the kernel.
+ * Errors are reported as std::system_error.
+ */
+class mapped_file
+{
+public:
+    /**
+     * @brief
+     * Construct a new mapped file
+     * @param path Path of the file
+     * @param mode How the file is opened
+     * @param size Size in bytes of the created file (create mode only)
+     */
+    mapped_file(const std::string &path, map_mode mode, std::size_t size = 0)
+    {
+        int flags{mode == map_mode::read_only ? O_RDONLY : O_RDWR};
+
+        if (mode == map_mode::create)
+            flags |= O_CREAT | O_TRUNC;
+
+        descriptor = ::open(path.c_str(), flags, 0644);
+
+        if (descriptor < 0)
+            fail("could not open " + path);
+
+        if (mode == map_mode::create)
+        {
+            if (::ftruncate(descriptor, static_cast<off_t>(size)) != 0)
+                abandon("could not resize " + path);
+
+            length = size;
+        }
+
+        else
+        {
+            struct stat info;
+
+            if (::fstat(descriptor, &info) != 0)
+                abandon("could not stat " + path);
+
+            length = static_cast<std::size_t>(info.st_size);
+        }
+
+        // mmap rejects empty mappings; an empty file is an empty span
+        if (length == 0)
+            return;
+
+        int protection{mode == map_mode::read_only
+                           ? PROT_READ
+                           : PROT_READ | PROT_WRITE};
+
+        void *address{::mmap(nullptr, length, protection, MAP_SHARED,
+                             descriptor, 0)};
+
+        if (address == MAP_FAILED)
+            abandon("could not map " + path);
+
+        memory = static_cast<std::byte *>(address);
+
+#ifdef MADV_HUGEPAGE
+        // Fewer TLB misses on multi-GB datasets, where the kernel supports
+        // transparent huge pages for the file; ignored otherwise
+        ::madvise(memory, length, MADV_HUGEPAGE);
+#endif
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept
+        : descriptor{std::exchange(other.descriptor, -1)},
+          memory{std::exchange(other.memory, nullptr)},
+          length{std::exchange(other.length, 0)}
+    {
+    }
+
+    ~mapped_file()
+    {
+        if (memory)
+            ::munmap(memory, length);
+
+        if (descriptor >= 0)
+            ::close(descriptor);
+    }
+
+    /**
+     * @brief
+     * Views the mapping as an array of fixed-width keys. Trailing bytes
+     * that do not make up a whole key are ignored.
+     * @tparam T Type of the keys
+     * @return std::span<T> Keys of the file
+     */
+    template <typename T>
+    std::span<T> as() const
+    {
+        return {reinterpret_cast<T *>(memory), length / sizeof(T)};
+    }
+
+    /**
+     * @brief
+     * Tells the kernel how the mapping will be accessed next. Sequential
+     * access enables aggressive read-ahead, random access disables it.
+     * @param pattern Access pattern of the next phase
+     * @param prefetch Whether the whole file should be read in now
+     */
+    void advise(access_pattern pattern, bool prefetch = false) const
+    {
+        if (!memory)
+            return;
+
+        int advice{MADV_NORMAL};
+
+        if (pattern == access_pattern::sequential)
+            advice = MADV_SEQUENTIAL;
+
+        else if (pattern == access_pattern::random)
+            advice = MADV_RANDOM;
+
+        ::madvise(memory, length, advice);
+
+        if (prefetch)
+            ::madvise(memory, length, MADV_WILLNEED);
+    }
+
+    /**
+     * @brief
+     * Writes the dirty pages back to the file and waits for it.
+     */
+    void flush() const
+    {
+        if (memory && ::msync(memory, length, MS_SYNC) != 0)
+            fail("could not write back the mapping");
+    }
+
+    std::size_t size() const { return length; }
+
+private:
+    [[noreturn]] static void fail(const std::string &what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+    /**
+     * @brief
+     * Closes the descriptor of a half constructed mapping and throws.
+     * @param what Description of the error
+     */
+    [[noreturn]] void abandon(const std::string &what)
+    {
+        int error{errno};
+        ::close(descriptor);
+
+        throw std::system_error{error, std::generic_category(), what};
+    }
+
+    int descriptor{-1};
+    std::byte *memory{nullptr};
+    std::size_t length{};
+};
+
+#endif //! MAPPED_FILE_H
@@ -0,0 +1,62 @@
+/**
+ * @file operation_counter.h
+ * @author Carlos Salguero
+ * @brief Recorders that count or discard the operations of a sort
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef OPERATION_COUNTER_H
+#define OPERATION_COUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief
+ * Receives the operations of a sort, as indices into the sorted sequence.
+ * Recorders are the rendering policy of the sorts: the operation log feeds
+ * the player, the others never reach the screen.
+ */
+template <typename R>
+concept sort_recorder = requires(R recorder, std::size_t index) {
+    recorder.compare(index, index);
+    recorder.swap(index, index);
+};
+
+/**
+ * @brief
+ * Recorder that only counts the operations of a sort. Used by the headless
+ * benchmark, where logging every event would dominate the run time.
+ */
+struct operation_counter
+{
+    std::uint64_t comparisons{};
+    std::uint64_t swaps{};
+    std::uint64_t writes{};
+
+    void compare(std::size_t, std::size_t) { ++comparisons; }
+    void swap(std::size_t, std::size_t) { ++swaps; }
+
+    template <typename V>
+    void write(std::size_t, const V &) { ++writes; }
+};
+
+/**
+ * @brief
+ * Recorder that discards every operation. Sorts instantiated with it
+ * compile down to the bare algorithm, which is what gets timed.
+ */
+struct null_recorder
+{
+    void compare(std::size_t, std::size_t) {}
+    void swap(std::size_t, std::size_t) {}
+
+    template <typename V>
+    void write(std::size_t, const V &) {}
+};
+
+#endif //! OPERATION_COUNTER_H
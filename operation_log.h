@@ -0,0 +1,153 @@
+/**
+ * @file operation_log.h
+ * @author Carlos Salguero
+ * @brief In-memory log of the operations performed by a sorting algorithm
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef OPERATION_LOG_H
+#define OPERATION_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief
+ * Kind of event emitted by a sorting algorithm.
+ */
+enum class operation_kind : std::uint8_t
+{
+    compare,
+    swap,
+    write
+};
+
+/**
+ * @brief
+ * A single event of a sort run. For compare and swap events both fields
+ * are element indices; for write events, first is the index and second
+ * holds the value written.
+ */
+struct operation
+{
+    operation_kind kind;
+    std::uint32_t first;
+    std::uint32_t second;
+};
+
+/**
+ * @brief
+ * Applies a single operation of the log to the data.
+ * @param data_vec Vector with the data
+ * @param op Operation to be applied
+ */
+inline void apply_operation(std::vector<int> &data_vec, const operation &op)
+{
+    switch (op.kind)
+    {
+    case operation_kind::compare:
+        break;
+
+    case operation_kind::swap:
+        std::swap(data_vec[op.first], data_vec[op.second]);
+        break;
+
+    case operation_kind::write:
+        data_vec[op.first] = static_cast<int>(op.second);
+        break;
+    }
+}
+
+/**
+ * @brief
+ * Append-only log of the operations performed by a sort. The buffer is
+ * allocated once up front, so recording an event is a plain store and the
+ * algorithm runs at full speed. The log is animated afterwards by a player.
+ */
+class operation_log
+{
+public:
+    /**
+     * @brief
+     * Construct a new operation log
+     * @param capacity Number of events to preallocate
+     */
+    explicit operation_log(std::size_t capacity = 0)
+    {
+        operations.reserve(capacity);
+    }
+
+    /**
+     * @brief
+     * Records the comparison of two elements
+     * @param first Index of the first element
+     * @param second Index of the second element
+     */
+    void compare(std::size_t first, std::size_t second)
+    {
+        operations.push_back({operation_kind::compare,
+                              static_cast<std::uint32_t>(first),
+                              static_cast<std::uint32_t>(second)});
+    }
+
+    /**
+     * @brief
+     * Records the swap of two elements
+     * @param first Index of the first element
+     * @param second Index of the second element
+     */
+    void swap(std::size_t first, std::size_t second)
+    {
+        operations.push_back({operation_kind::swap,
+                              static_cast<std::uint32_t>(first),
+                              static_cast<std::uint32_t>(second)});
+    }
+
+    /**
+     * @brief
+     * Records a write of a value into an element
+     * @param index Index of the element written
+     * @param value Value written
+     */
+    void write(std::size_t index, int value)
+    {
+        operations.push_back({operation_kind::write,
+                              static_cast<std::uint32_t>(index),
+                              static_cast<std::uint32_t>(value)});
+    }
+
+    /**
+     * @brief
+     * Reserves space for at least capacity events
+     * @param capacity Number of events
+     */
+    void reserve(std::size_t capacity) { operations.reserve(capacity); }
+
+    /**
+     * @brief
+     * Removes every event while keeping the allocated buffer.
+     */
+    void clear() { operations.clear(); }
+
+    std::size_t size() const { return operations.size(); }
+    bool empty() const { return operations.empty(); }
+
+    const operation &operator[](std::size_t index) const
+    {
+        return operations[index];
+    }
+
+    auto begin() const { return operations.begin(); }
+    auto end() const { return operations.end(); }
+
+private:
+    std::vector<operation> operations;
+};
+
+#endif //! OPERATION_LOG_H
@@ -0,0 +1,94 @@
+/**
+ * @file operation_stream.h
+ * @author Carlos Salguero
+ * @brief Streams the operations of a sort running on another thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef OPERATION_STREAM_H
+#define OPERATION_STREAM_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+// Operations and the ring they travel through
+#include "operation_log.h"
+#include "spsc_queue.h"
+
+using operation_queue = spsc_queue<operation>;
+
+/**
+ * @brief
+ * Recorder that pushes every operation into a queue read by the render
+ * thread. When the queue is full the sort waits for the player to catch up
+ * (backpressure), so memory stays bounded whatever the operation count.
+ * Once a stop is requested the remaining operations are dropped and the
+ * sort runs to completion without waiting.
+ */
+class stream_recorder
+{
+public:
+    stream_recorder(operation_queue &queue, std::stop_token stop)
+        : queue{queue}, stop{std::move(stop)}
+    {
+    }
+
+    void compare(std::size_t first, std::size_t second)
+    {
+        push({operation_kind::compare, static_cast<std::uint32_t>(first),
+              static_cast<std::uint32_t>(second)});
+    }
+
+    void swap(std::size_t first, std::size_t second)
+    {
+        push({operation_kind::swap, static_cast<std::uint32_t>(first),
+              static_cast<std::uint32_t>(second)});
+    }
+
+    template <typename V>
+    void write(std::size_t index, const V &value)
+    {
+        push({operation_kind::write, static_cast<std::uint32_t>(index),
+              static_cast<std::uint32_t>(value)});
+    }
+
+private:
+    static constexpr int spins{64};
+
+    void push(const operation &op)
+    {
+        if (stopped)
+            return;
+
+        // A short spin covers the player draining a frame; past that the
+        // ring is full for a whole frame and the thread sleeps
+        for (int attempt{}; !queue.try_push(op); ++attempt)
+        {
+            if (stop.stop_requested())
+            {
+                stopped = true;
+                return;
+            }
+
+            if (attempt < spins)
+                std::this_thread::yield();
+
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+
+    operation_queue &queue;
+    std::stop_token stop;
+    bool stopped{false};
+};
+
+#endif //! OPERATION_STREAM_H
@@ -0,0 +1,746 @@
+/**
+ * @file parallel_sorts.h
+ * @author Carlos Salguero
+ * @brief Parallel sorting engines, meant for large inputs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PARALLEL_SORTS_H
+#define PARALLEL_SORTS_H
+
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+// Thread pool and scratch memory
+#include "thread_pool.h"
+#include "scratch_buffer.h"
+
+// Vectorized partition kernels
+#include "simd_partition.h"
+
+// Branchless base cases
+#include "sorting_network.h"
+
+// Ranges smaller than this are sorted by a single thread
+constexpr std::size_t parallel_cutoff{1 << 15};
+
+// Ranges larger than this are partitioned by every thread of the pool
+constexpr std::size_t parallel_partition_cutoff{1 << 21};
+
+// Ranges smaller than this are finished by a sorting network or insertion
+// sort
+constexpr std::size_t insertion_cutoff{24};
+
+// Longest run the merge sort sorts before merging
+constexpr std::size_t merge_run_limit{32};
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Partitions data[0, size) so the elements that satisfy is_left come first.
+ * @tparam T Type of the data
+ * @tparam Predicate Callable taking an element
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param is_left Whether an element belongs to the left side
+ * @return std::size_t Number of elements on the left side
+ */
+template <typename T, typename Predicate>
+std::size_t partition_block(T *data, std::size_t size, Predicate is_left)
+{
+    T *first{data};
+    T *last{data + size};
+
+    while (true)
+    {
+        while (first < last && is_left(*first))
+            ++first;
+
+        while (first < last && !is_left(*(last - 1)))
+            --last;
+
+        if (first >= last)
+            break;
+
+        std::swap(*first, *(last - 1));
+        ++first;
+        --last;
+    }
+
+    return static_cast<std::size_t>(first - data);
+}
+
+/**
+ * @brief
+ * Partitions data[0, size) with every thread of the pool. Each thread
+ * partitions one block in place; the elements left on the wrong side of the
+ * final boundary are then swapped pairwise, also in parallel.
+ * @tparam T Type of the data
+ * @tparam BlockPartition Callable partitioning a block in place
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param partition_one Partitions a block, returns its left count
+ * @param pool Pool running the blocks
+ * @return std::size_t Number of elements on the left side
+ */
+template <typename T, typename BlockPartition>
+std::size_t parallel_partition(T *data, std::size_t size,
+                               BlockPartition partition_one,
+                               work_stealing_pool &pool)
+{
+    std::size_t blocks{pool.size() + 1};
+    std::size_t block_size{(size + blocks - 1) / blocks};
+    std::vector<std::size_t> lefts(blocks);
+
+    pool.parallel_for(blocks,
+                      [&](std::size_t block)
+                      {
+                          std::size_t begin{std::min(block * block_size,
+                                                     size)};
+                          std::size_t end{std::min(begin + block_size, size)};
+
+                          lefts[block] = partition_one(data + begin,
+                                                       end - begin);
+                      });
+
+    std::size_t boundary{std::accumulate(lefts.begin(), lefts.end(),
+                                         std::size_t{0})};
+
+    // Right elements before the boundary and left elements after it, as
+    // [begin, end) intervals in increasing order
+    std::vector<std::pair<std::size_t, std::size_t>> wrong_right;
+    std::vector<std::pair<std::size_t, std::size_t>> wrong_left;
+
+    for (std::size_t block{}; block < blocks; ++block)
+    {
+        std::size_t begin{std::min(block * block_size, size)};
+        std::size_t end{std::min(begin + block_size, size)};
+        std::size_t middle{begin + lefts[block]};
+
+        if (middle < boundary && middle < end)
+            wrong_right.push_back({middle, std::min(end, boundary)});
+
+        if (begin < middle && middle > boundary)
+            wrong_left.push_back({std::max(begin, boundary), middle});
+    }
+
+    auto prefix{[](const auto &intervals)
+                {
+                    std::vector<std::size_t> sums{0};
+
+                    for (auto [begin, end] : intervals)
+                        sums.push_back(sums.back() + end - begin);
+
+                    return sums;
+                }};
+
+    auto right_sums{prefix(wrong_right)};
+    auto left_sums{prefix(wrong_left)};
+    std::size_t misplaced{right_sums.back()};
+
+    // Position of the k-th element of a list of intervals
+    auto locate{[](const auto &intervals, const auto &sums, std::size_t k)
+                {
+                    std::size_t interval{static_cast<std::size_t>(
+                        std::upper_bound(sums.begin(), sums.end(), k) -
+                        sums.begin() - 1)};
+
+                    return std::pair{interval,
+                                     intervals[interval].first + k -
+                                         sums[interval]};
+                }};
+
+    pool.parallel_for(
+        blocks,
+        [&](std::size_t block)
+        {
+            std::size_t k{misplaced * block / blocks};
+            std::size_t end{misplaced * (block + 1) / blocks};
+
+            if (k >= end)
+                return;
+
+            auto [r, right] = locate(wrong_right, right_sums, k);
+            auto [l, left] = locate(wrong_left, left_sums, k);
+
+            for (; k < end; ++k)
+            {
+                if (right == wrong_right[r].second)
+                    right = wrong_right[++r].first;
+
+                if (left == wrong_left[l].second)
+                    left = wrong_left[++l].first;
+
+                std::swap(data[right++], data[left++]);
+            }
+        });
+
+    return boundary;
+}
+
+/**
+ * @brief
+ * Median of the first, middle and last elements of a range.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @return T Pivot value
+ */
+template <typename T, typename Compare>
+T median_of_three(const T *data, std::size_t size, Compare compare)
+{
+    const T &a{data[0]};
+    const T &b{data[size / 2]};
+    const T &c{data[size - 1]};
+
+    if (compare(a, b))
+        return compare(b, c) ? b : (compare(a, c) ? c : a);
+
+    return compare(a, c) ? a : (compare(b, c) ? c : b);
+}
+
+/**
+ * @brief
+ * Insertion sort of data[0, size).
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ */
+template <typename T, typename Compare>
+void insertion_sort_block(T *data, std::size_t size, Compare compare)
+{
+    for (std::size_t i{1}; i < size; ++i)
+    {
+        T value{std::move(data[i])};
+        std::size_t j{i};
+
+        for (; j > 0 && compare(value, data[j - 1]); --j)
+            data[j] = std::move(data[j - 1]);
+
+        data[j] = std::move(value);
+    }
+}
+
+/**
+ * @brief
+ * Heap sort of data[0, size), the fallback of the quick sorts once their
+ * partitions keep coming out lopsided.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ */
+template <typename T, typename Compare>
+void heap_sort_block(T *data, std::size_t size, Compare compare)
+{
+    std::make_heap(data, data + size, compare);
+    std::sort_heap(data, data + size, compare);
+}
+
+/**
+ * @brief
+ * Whether a split of data[0, size) left one side with less than an eighth
+ * of the range.
+ * @param size Number of elements
+ * @param left End of the left side
+ * @param right Beginning of the right side
+ * @return true The split is lopsided
+ * @return false The split is balanced enough
+ */
+inline bool lopsided_split(std::size_t size, std::size_t left,
+                           std::size_t right)
+{
+    return std::min(left, size - right) < size / 8;
+}
+
+/**
+ * @brief
+ * Sorts data[0, size), at most Limit elements, with the sorting network
+ * of its size when the elements are small values, with insertion sort
+ * otherwise.
+ * @tparam Limit Largest size of the range
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ */
+template <std::size_t Limit, typename T, typename Compare>
+void small_sort_block(T *data, std::size_t size, Compare compare)
+{
+    if constexpr (network_sortable<T *>)
+    {
+        std::identity proj;
+        null_recorder recorder;
+
+        network_sort_range<Limit>(data, 0, size, compare, proj, recorder);
+    }
+
+    else
+        insertion_sort_block(data, size, compare);
+}
+
+/**
+ * @brief
+ * Splits data[0, size) around a median of three pivot. Runs of keys equal
+ * to the pivot are split off on their own, so duplicates cannot stall the
+ * recursion. Primitive keys sorted by std::less or std::greater go through
+ * the vectorized kernels.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param pool Pool used for large ranges, or nullptr
+ * @return std::pair<std::size_t, std::size_t> End of the left side and
+ * beginning of the right side; everything in between equals the pivot
+ */
+template <typename T, typename Compare>
+std::pair<std::size_t, std::size_t>
+split_range(T *data, std::size_t size, Compare compare,
+            work_stealing_pool *pool)
+{
+    T pivot{median_of_three(data, size, compare)};
+
+    auto partition{[&](bool or_equal)
+                   {
+                       auto partition_one{
+                           [&](T *block, std::size_t block_size)
+                           {
+                               if constexpr (simd_partitionable<T, Compare>)
+                                   return simd_partition(
+                                       block, block_size, pivot,
+                                       partition_kind_of<T, Compare>(
+                                           or_equal));
+
+                               else if (or_equal)
+                                   return partition_block(
+                                       block, block_size,
+                                       [&](const T &value)
+                                       { return !compare(pivot, value); });
+
+                               else
+                                   return partition_block(
+                                       block, block_size,
+                                       [&](const T &value)
+                                       { return compare(value, pivot); });
+                           }};
+
+                       if (pool && size >= parallel_partition_cutoff)
+                           return parallel_partition(data, size,
+                                                     partition_one, *pool);
+
+                       return partition_one(data, size);
+                   }};
+
+    std::size_t left{partition(false)};
+
+    if (left > 0)
+        return {left, left};
+
+    // Nothing is smaller than the pivot: the keys equal to it go first
+    std::size_t equal{partition(true)};
+
+    return {0, equal};
+}
+
+/**
+ * @brief
+ * Single threaded quick sort of data[0, size). Once too many partitions
+ * were lopsided the range falls back to heap sort, which bounds the worst
+ * case to O(n log n).
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param bad_allowed Lopsided partitions left before falling back
+ */
+template <typename T, typename Compare>
+void sequential_quick_sort(T *data, std::size_t size, Compare compare,
+                           std::size_t bad_allowed)
+{
+    while (size > insertion_cutoff)
+    {
+        auto [left, right] = split_range(data, size, compare, nullptr);
+
+        if (lopsided_split(size, left, right) && --bad_allowed == 0)
+        {
+            heap_sort_block(data, left, compare);
+            heap_sort_block(data + right, size - right, compare);
+            return;
+        }
+
+        // Recurse into the smaller side, loop on the larger one
+        if (left < size - right)
+        {
+            sequential_quick_sort(data, left, compare, bad_allowed);
+            data += right;
+            size -= right;
+        }
+
+        else
+        {
+            sequential_quick_sort(data + right, size - right, compare,
+                                  bad_allowed);
+            size = left;
+        }
+    }
+
+    small_sort_block<insertion_cutoff>(data, size, compare);
+}
+
+/**
+ * @brief
+ * Task of the parallel quick sort. Keeps splitting its range, handing the
+ * smaller side to the pool, until the range is small enough to be sorted
+ * sequentially. Shares the heap sort fallback of the sequential sort.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param bad_allowed Lopsided partitions left before falling back
+ * @param pool Pool running the tasks
+ * @param pending Number of unfinished tasks of the sort
+ */
+template <typename T, typename Compare>
+void quick_sort_task(T *data, std::size_t size, Compare compare,
+                     std::size_t bad_allowed, work_stealing_pool &pool,
+                     std::atomic<std::size_t> &pending)
+{
+    while (size > parallel_cutoff)
+    {
+        auto [left, right] = split_range(data, size, compare, &pool);
+
+        if (lopsided_split(size, left, right) && --bad_allowed == 0)
+        {
+            heap_sort_block(data, left, compare);
+            heap_sort_block(data + right, size - right, compare);
+            return;
+        }
+
+        T *spawned{data};
+        std::size_t spawned_size{left};
+
+        if (left < size - right)
+        {
+            data += right;
+            size -= right;
+        }
+
+        else
+        {
+            spawned = data + right;
+            spawned_size = size - right;
+            size = left;
+        }
+
+        if (spawned_size == 0)
+            continue;
+
+        pending.fetch_add(1, std::memory_order_relaxed);
+
+        pool.submit(
+            [spawned, spawned_size, compare, bad_allowed, &pool, &pending]
+            {
+                quick_sort_task(spawned, spawned_size, compare, bad_allowed,
+                                pool, pending);
+                pending.fetch_sub(1, std::memory_order_release);
+            });
+    }
+
+    sequential_quick_sort(data, size, compare, bad_allowed);
+}
+
+/**
+ * @brief
+ * Merge Path: the number of elements of the left run among the first
+ * diagonal elements of the stable merge of two sorted runs, found by a
+ * binary search along the diagonal. Cutting two runs at the merge paths of
+ * evenly spaced diagonals splits their merge into independent pieces of
+ * exactly equal output, whatever the distribution of the keys.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param left First element of the left run
+ * @param left_size Number of elements of the left run
+ * @param right First element of the right run
+ * @param right_size Number of elements of the right run
+ * @param diagonal Number of merged elements, at most both sizes together
+ * @param compare Ordering of the sort
+ * @return std::size_t Elements taken from the left run
+ */
+template <typename T, typename Compare>
+std::size_t merge_path(const T *left, std::size_t left_size, const T *right,
+                       std::size_t right_size, std::size_t diagonal,
+                       Compare compare)
+{
+    std::size_t low{diagonal > right_size ? diagonal - right_size : 0};
+    std::size_t high{std::min(diagonal, left_size)};
+
+    while (low < high)
+    {
+        auto middle{low + (high - low) / 2};
+
+        if (compare(right[diagonal - middle - 1], left[middle]))
+            high = middle;
+
+        else
+            low = middle + 1;
+    }
+
+    return low;
+}
+
+/**
+ * @brief
+ * Stable merge of two sorted blocks: ties are taken from the left one.
+ * The pointers advance without a branch on the outcome of the comparison.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param left First element of the left block
+ * @param left_end End of the left block
+ * @param right First element of the right block
+ * @param right_end End of the right block
+ * @param out Receives the merged elements
+ * @param compare Ordering of the sort
+ */
+template <typename T, typename Compare>
+void merge_blocks(const T *left, const T *left_end, const T *right,
+                  const T *right_end, T *out, Compare compare)
+{
+    while (left != left_end && right != right_end)
+    {
+        bool take_right{compare(*right, *left)};
+
+        *out++ = take_right ? *right : *left;
+        right += take_right;
+        left += !take_right;
+    }
+
+    out = std::copy(left, left_end, out);
+    std::copy(right, right_end, out);
+}
+
+/**
+ * @brief
+ * One pass of the parallel merge sort: merges pairs of runs of source
+ * into target. The output is cut into one equal share per task, and every
+ * task merges the pieces of the merges its share overlaps, cut at their
+ * merge paths. Many small merges and a single huge one spread over the
+ * tasks alike.
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param source Runs of the pass
+ * @param target Receives the merged runs
+ * @param size Number of elements
+ * @param run Length of the runs
+ * @param compare Ordering of the sort
+ * @param pool Pool running the tasks
+ * @param tasks Number of shares of the output
+ */
+template <typename T, typename Compare>
+void merge_pass(const T *source, T *target, std::size_t size,
+                std::size_t run, Compare compare, work_stealing_pool &pool,
+                std::size_t tasks)
+{
+    auto share{[&](std::size_t task)
+               {
+                   auto begin{task * size / tasks};
+                   auto end{(task + 1) * size / tasks};
+
+                   for (auto low{begin / (2 * run) * (2 * run)}; low < end;
+                        low += 2 * run)
+                   {
+                       auto middle{std::min(low + run, size)};
+                       auto high{std::min(low + 2 * run, size)};
+
+                       const T *left{source + low};
+                       const T *right{source + middle};
+
+                       auto first{std::max(begin, low) - low};
+                       auto last{std::min(end, high) - low};
+
+                       // Runs already in order are copied as they are
+                       if (middle == high ||
+                           !compare(*right, source[middle - 1]))
+                       {
+                           std::copy(left + first, left + last,
+                                     target + low + first);
+                           continue;
+                       }
+
+                       auto left_first{merge_path(left, middle - low, right,
+                                                  high - middle, first,
+                                                  compare)};
+                       auto left_last{merge_path(left, middle - low, right,
+                                                 high - middle, last,
+                                                 compare)};
+
+                       merge_blocks(left + left_first, left + left_last,
+                                    right + (first - left_first),
+                                    right + (last - left_last),
+                                    target + low + first, compare);
+                   }
+               }};
+
+    if (tasks == 1)
+        share(0);
+
+    else
+        pool.parallel_for(tasks, share);
+}
+
+// Sort Functions
+/**
+ * @brief
+ * Parallel Quick Sort. Subranges above parallel_cutoff are sent to the
+ * work stealing pool and the largest ones are also partitioned in parallel.
+ * Subranges whose partitions keep coming out lopsided are heap sorted, so
+ * adversarial inputs stay O(n log n).
+ * @tparam T Type of the data
+ * @tparam Compare Ordering of the sort
+ * @param data First element
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param pool Pool running the sort
+ */
+template <typename T, typename Compare = std::less<T>>
+void parallel_quick_sort(T *data, std::size_t size, Compare compare = {},
+                         work_stealing_pool &pool = shared_pool())
+{
+    std::atomic<std::size_t> pending{0};
+
+    quick_sort_task(data, size, compare,
+                    static_cast<std::size_t>(std::bit_width(size)), pool,
+                    pending);
+    pool.wait(pending);
+}
+
+/**
+ * @brief
+ * Parallel Merge Sort: stable, O(n log n) whatever the input. Runs of at
+ * most merge_run_limit elements are sorted by a network for integer keys
+ * and by insertion sort otherwise, then every pass merges pairs of runs
+ * between the data and one scratch buffer, reused across calls, so the
+ * sort allocates nothing once the buffer has grown.
+ * The run length is size / 4^k rounded up, which makes the number of
+ * passes even, so the last pass lands in the data. Every pass is split
+ * into equal shares with Merge Path, so the last passes, made of a few
+ * long merges, keep every thread busy.
+ * @tparam T Type of the data, trivially copyable
+ * @tparam Compare Ordering of the sort
+ * @param data First element
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param pool Pool running the sort
+ * @param scratch Scratch memory reused across calls
+ */
+template <typename T, typename Compare = std::less<T>>
+void parallel_merge_sort(T *data, std::size_t size, Compare compare = {},
+                         work_stealing_pool &pool = shared_pool(),
+                         scratch_buffer &scratch = thread_scratch())
+{
+    if (size < 2)
+        return;
+
+    T *buffer{scratch.get<T>(size)};
+
+    auto width{size};
+
+    while (width > merge_run_limit)
+        width = (width + 3) / 4;
+
+    // A few shares per thread, none smaller than a sequential range
+    auto tasks{std::clamp<std::size_t>(size / parallel_cutoff, 1,
+                                       4 * (pool.size() + 1))};
+    auto runs{(size + width - 1) / width};
+
+    auto sort_runs{[&](std::size_t task)
+                   {
+                       for (auto index{task * runs / tasks};
+                            index < (task + 1) * runs / tasks; ++index)
+                       {
+                           auto low{index * width};
+                           auto run{std::min(width, size - low)};
+
+                           // Unstable, unless equal keys are identical, and
+                           // not adaptive, so runs in order are skipped
+                           if constexpr (interchangeable_ties<T *, Compare,
+                                                              std::identity>)
+                           {
+                               if (!std::is_sorted(data + low,
+                                                   data + low + run, compare))
+                                   small_sort_block<merge_run_limit>(
+                                       data + low, run, compare);
+                           }
+
+                           else
+                               insertion_sort_block(data + low, run, compare);
+                       }
+                   }};
+
+    if (tasks == 1)
+        sort_runs(0);
+
+    else
+        pool.parallel_for(tasks, sort_runs);
+
+    for (; width < size; width *= 4)
+    {
+        merge_pass(data, buffer, size, width, compare, pool, tasks);
+        merge_pass(buffer, data, size, 2 * width, compare, pool, tasks);
+    }
+}
+
+/**
+ * @brief
+ * Parallel Merge Sort over a vector.
+ * @tparam T Type of vector's data
+ * @tparam Compare Ordering of the sort
+ * @param data_vec Vector with data to be sorted
+ * @param compare Ordering of the sort
+ * @param pool Pool running the sort
+ * @param scratch Scratch memory reused across calls
+ */
+template <typename T, typename Compare = std::less<T>>
+void parallel_merge_sort(std::vector<T> &data_vec, Compare compare = {},
+                         work_stealing_pool &pool = shared_pool(),
+                         scratch_buffer &scratch = thread_scratch())
+{
+    parallel_merge_sort(data_vec.data(), data_vec.size(), compare, pool,
+                        scratch);
+}
+
+/**
+ * @brief
+ * Parallel Quick Sort over a vector.
+ * @tparam T Type of vector's data
+ * @tparam Compare Ordering of the sort
+ * @param data_vec Vector with data to be sorted
+ * @param compare Ordering of the sort
+ * @param pool Pool running the sort
+ */
+template <typename T, typename Compare = std::less<T>>
+void parallel_quick_sort(std::vector<T> &data_vec, Compare compare = {},
+                         work_stealing_pool &pool = shared_pool())
+{
+    parallel_quick_sort(data_vec.data(), data_vec.size(), compare, pool);
+}
+
+#endif //! PARALLEL_SORTS_H
@@ -0,0 +1,259 @@
+/**
+ * @file perf_counters.h
+ * @author Carlos Salguero
+ * @brief Hardware performance counters around a sort and its phases
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Phases of a sort
+#include "sort_phase.h"
+
+// Events measured, in the order of the arrays of a perf_sample
+constexpr std::size_t perf_event_count{6};
+
+constexpr std::array<const char *, perf_event_count> perf_event_names{
+    "instructions", "cycles",     "branch_misses",
+    "l1d_misses",   "llc_misses", "dtlb_misses"};
+
+/**
+ * @brief
+ * Counter values and wall time of an interval. Events the machine could not
+ * count (no PMU in a VM, perf_event_paranoid too strict) are not available.
+ */
+struct perf_sample
+{
+    double wall_ns{};
+    std::array<std::uint64_t, perf_event_count> values{};
+    std::array<bool, perf_event_count> available{};
+
+    perf_sample &operator+=(const perf_sample &other)
+    {
+        wall_ns += other.wall_ns;
+
+        for (std::size_t event{}; event < perf_event_count; ++event)
+        {
+            values[event] += other.values[event];
+            available[event] = other.available[event];
+        }
+
+        return *this;
+    }
+
+    friend perf_sample operator-(perf_sample end, const perf_sample &start)
+    {
+        end.wall_ns -= start.wall_ns;
+
+        for (std::size_t event{}; event < perf_event_count; ++event)
+            end.values[event] -= start.values[event];
+
+        return end;
+    }
+};
+
+/**
+ * @brief
+ * Counters of a whole run and of each of its phases.
+ */
+struct perf_report
+{
+    perf_sample total;
+    std::array<perf_sample, sort_phase_count> phases;
+    std::array<std::uint64_t, sort_phase_count> phase_calls{};
+};
+
+/**
+ * @brief
+ * Set of counters of the calling thread, opened with perf_event_open.
+ * Every event is opened on its own so one missing event does not take the
+ * others down; kernel time is excluded, which perf_event_paranoid 2 allows.
+ * Counters run from construction on and are read in user space, so an
+ * interval is the difference between two snapshots.
+ */
+class perf_counters
+{
+public:
+    perf_counters()
+    {
+#ifdef __linux__
+        constexpr auto cache_miss{[](std::uint64_t cache)
+                                  {
+                                      return cache |
+                                             PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS
+                                                 << 16;
+                                  }};
+
+        const std::array<std::pair<std::uint32_t, std::uint64_t>,
+                         perf_event_count>
+            events{{{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+                    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+                    {PERF_TYPE_HW_CACHE,
+                     cache_miss(PERF_COUNT_HW_CACHE_DTLB)}}};
+
+        for (std::size_t event{}; event < perf_event_count; ++event)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[event].first;
+            attr.config = events[event].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            descriptors[event] = static_cast<int>(
+                ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters()
+    {
+#ifdef __linux__
+        for (int descriptor : descriptors)
+        {
+            if (descriptor >= 0)
+                ::close(descriptor);
+        }
+#endif
+    }
+
+    /**
+     * @brief
+     * Whether at least one event could be opened.
+     * @return true Some event is counted
+     * @return false Only wall time is measured
+     */
+    bool available() const
+    {
+        for (int descriptor : descriptors)
+        {
+            if (descriptor >= 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief
+     * Current value of every counter and of the clock. Counters that were
+     * multiplexed with other events are scaled to the whole interval.
+     * @return perf_sample Snapshot of the counters
+     */
+    perf_sample snapshot() const
+    {
+        perf_sample sample;
+
+#ifdef __linux__
+        for (std::size_t event{}; event < perf_event_count; ++event)
+        {
+            // value, time enabled, time running
+            std::array<std::uint64_t, 3> data{};
+
+            if (descriptors[event] < 0 ||
+                ::read(descriptors[event], data.data(), sizeof(data)) !=
+                    static_cast<ssize_t>(sizeof(data)))
+                continue;
+
+            sample.available[event] = true;
+            sample.values[event] =
+                data[2] > 0 && data[2] < data[1]
+                    ? static_cast<std::uint64_t>(static_cast<double>(data[0]) *
+                                                 data[1] / data[2])
+                    : data[0];
+        }
+#endif
+
+        sample.wall_ns = std::chrono::duration<double, std::nano>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+
+        return sample;
+    }
+
+private:
+    std::array<int, perf_event_count> descriptors{-1, -1, -1, -1, -1, -1};
+};
+
+/**
+ * @brief
+ * Recorder that measures a run and its phases with hardware counters. It
+ * ignores the individual operations; every phase boundary costs one read
+ * per event, which shows up in the wall time of phase heavy runs.
+ */
+class perf_recorder
+{
+public:
+    explicit perf_recorder(const perf_counters &counters)
+        : counters{counters}
+    {
+    }
+
+    void compare(std::size_t, std::size_t) {}
+    void swap(std::size_t, std::size_t) {}
+
+    template <typename V>
+    void write(std::size_t, const V &) {}
+
+    void begin_phase(sort_phase) { phase_start = counters.snapshot(); }
+
+    void end_phase(sort_phase phase)
+    {
+        auto index{static_cast<std::size_t>(phase)};
+
+        result.phases[index] += counters.snapshot() - phase_start;
+        ++result.phase_calls[index];
+    }
+
+    /**
+     * @brief
+     * Starts measuring a run, discarding the previous one.
+     */
+    void start()
+    {
+        result = {};
+        run_start = counters.snapshot();
+    }
+
+    /**
+     * @brief
+     * Stops measuring the run.
+     */
+    void stop() { result.total = counters.snapshot() - run_start; }
+
+    const perf_report &report() const { return result; }
+
+private:
+    const perf_counters &counters;
+    perf_sample run_start;
+    perf_sample phase_start;
+    perf_report result;
+};
+
+#endif //! PERF_COUNTERS_H
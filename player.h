@@ -0,0 +1,417 @@
+/**
+ * @file player.h
+ * @author Carlos Salguero
+ * @brief Animates the operations recorded or streamed by a sorting algorithm
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PLAYER_H
+#define PLAYER_H
+
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+// Operation log and stream
+#include "operation_log.h"
+#include "operation_stream.h"
+#include "trace_file.h"
+
+// Rendering
+#include "bar_renderer.h"
+#include "lod_renderer.h"
+#include "text_overlay.h"
+
+// Frame pacing
+#include "frame_scheduler.h"
+
+// Profiling zones
+#include "frame_graph.h"
+#include "profiler.h"
+
+/**
+ * @brief
+ * Applies a playback key: space pauses, the right arrow steps one
+ * operation, the up and down arrows double or halve the speed, and F shows
+ * or hides the frame-time graph of profiling builds.
+ * @param key Key pressed
+ * @param scheduler Frame pacing of the playback
+ */
+inline void control_playback(SDL_Keycode key, frame_scheduler &scheduler)
+{
+    switch (key)
+    {
+    case SDLK_SPACE:
+        scheduler.toggle_pause();
+        break;
+
+    case SDLK_RIGHT:
+        scheduler.step();
+        break;
+
+    case SDLK_UP:
+        scheduler.faster();
+        break;
+
+    case SDLK_DOWN:
+        scheduler.slower();
+        break;
+
+    case SDLK_f:
+        if (profiler_enabled)
+            profiler::instance().toggle_graph();
+
+        break;
+    }
+}
+
+/**
+ * @brief
+ * Step a seek key moves the playback of a trace to: home goes back to the
+ * start, page up and page down move a tenth of the run, and the left arrow
+ * steps one operation back.
+ * @param key Key pressed
+ * @param position Operations already played
+ * @param total Number of operations of the trace
+ * @return std::optional<std::size_t> Step to seek to, nothing for other keys
+ */
+inline std::optional<std::size_t> seek_target(SDL_Keycode key,
+                                              std::size_t position,
+                                              std::size_t total)
+{
+    auto jump{std::max<std::size_t>(total / 10, 1)};
+
+    switch (key)
+    {
+    case SDLK_HOME:
+        return 0;
+
+    case SDLK_PAGEUP:
+        return position - std::min(position, jump);
+
+    case SDLK_PAGEDOWN:
+        return std::min(position + jump, total);
+
+    case SDLK_LEFT:
+        if (position)
+            return position - 1;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief
+ * Describes the state of a playback.
+ * @param scheduler Frame pacing of the playback
+ * @param total Number of operations of the log
+ * @return std::string Status line
+ */
+inline std::string playback_status(const frame_scheduler &scheduler,
+                                   std::size_t total)
+{
+    char status[96];
+
+    std::snprintf(status, sizeof(status), "%s x%g  %zu/%zu ops",
+                  scheduler.is_paused() ? "paused" : "playing",
+                  scheduler.speed_factor(), scheduler.position(), total);
+
+    return status;
+}
+
+/**
+ * @brief
+ * Hands out the operations of a finished log in order, with the same
+ * interface as the consumer side of an operation_queue.
+ */
+struct log_source
+{
+    const operation_log &log;
+    std::size_t next{};
+
+    template <typename F>
+    std::size_t consume(std::size_t count, F &&function)
+    {
+        auto end{std::min(next + count, log.size())};
+        auto first{next};
+
+        for (; next < end; ++next)
+            function(log[next]);
+
+        return end - first;
+    }
+};
+
+/**
+ * @brief
+ * Plays operations through a renderer until they end or the window is
+ * closed. Renderers that keep aggregates of the data (lod_renderer) apply
+ * the operations themselves; they are also rebuilt when the window is
+ * resized, or when a source that can seek (trace_reader) jumps to another
+ * step.
+ * @tparam Source log_source, operation_queue or trace_reader
+ * @tparam View bar_renderer or lod_renderer
+ * @param source Operations of the sort
+ * @param total Number of operations of the sort
+ * @param data_vec Data as it was before the sort
+ * @param renderer Renderer where the render happens
+ * @param view Renderer of the data
+ * @param overlay Text drawn over every frame, or nullptr
+ * @param pacing Target duration or rate of the playback
+ * @return true The whole log was played
+ * @return false The window was closed during the playback
+ */
+template <typename Source, typename View>
+bool play_through(Source &source, std::size_t total,
+                  std::vector<int> &data_vec, SDL_Renderer *renderer,
+                  View &view, text_overlay *overlay,
+                  const playback_pacing &pacing)
+{
+    frame_scheduler scheduler{total, pacing};
+    text_overlay status{2, overlay_anchor::bottom_left};
+    frame_graph graph;
+
+    std::size_t red{data_vec.size()};
+    std::size_t blue{data_vec.size()};
+
+    // Redraws the whole array, after a resize or a seek
+    auto refresh{[&]
+                 {
+                     if constexpr (requires { view.resize(data_vec); })
+                         view.resize(data_vec);
+
+                     else
+                         view.invalidate();
+                 }};
+
+    while (!scheduler.finished())
+    {
+        SDL_Event event;
+        std::size_t granted{};
+        std::size_t applied{};
+
+        {
+            PROFILE_ZONE("events");
+
+            while (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    return false;
+
+                if (event.type == SDL_WINDOWEVENT &&
+                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                    refresh();
+
+                if (event.type != SDL_KEYDOWN)
+                    continue;
+
+                auto key{event.key.keysym.sym};
+
+                control_playback(key, scheduler);
+
+                // Sources that can seek rebuild the data at the target step
+                if constexpr (requires { source.seek(total, data_vec); })
+                {
+                    auto target{seek_target(key, scheduler.position(), total)};
+
+                    if (!target)
+                        continue;
+
+                    source.seek(*target, data_vec);
+                    scheduler.seek(*target);
+
+                    // Stepping back pauses, like stepping forward
+                    if (key == SDLK_LEFT && !scheduler.is_paused())
+                        scheduler.toggle_pause();
+
+                    red = blue = data_vec.size();
+                    refresh();
+                }
+            }
+        }
+
+        // Only the last operation of the frame is highlighted
+        {
+            PROFILE_ZONE("apply");
+
+            granted = scheduler.next_frame();
+            applied = source.consume(
+                granted, [&](const operation &op)
+                {
+                    if constexpr (requires { view.apply(data_vec, op); })
+                        view.apply(data_vec, op);
+
+                    else
+                        apply_operation(data_vec, op);
+
+                    red = op.first;
+                    blue = op.kind == operation_kind::write ? op.first
+                                                            : op.second;
+                });
+        }
+
+        scheduler.defer(granted - applied);
+
+        {
+            PROFILE_ZONE("geometry");
+
+            view.draw(data_vec, red, blue);
+
+            if (overlay)
+                overlay->draw(renderer);
+
+            status.set_lines({playback_status(scheduler, total)});
+            status.draw(renderer);
+            graph.draw(renderer);
+        }
+
+        {
+            PROFILE_ZONE("present");
+            SDL_RenderPresent(renderer);
+        }
+
+        {
+            PROFILE_ZONE("wait");
+            scheduler.wait_for_frame();
+        }
+
+        PROFILE_FRAME();
+    }
+
+    view.draw(data_vec, data_vec.size(), data_vec.size());
+
+    if (overlay)
+        overlay->draw(renderer);
+
+    SDL_RenderPresent(renderer);
+
+    return true;
+}
+
+/**
+ * @brief
+ * Plays operations with the renderer that fits the array: one bar per
+ * element when the array fits in the window, columns of elements
+ * otherwise.
+ * @tparam Source log_source, operation_queue or trace_reader
+ * @param source Operations of the sort
+ * @param total Number of operations of the sort
+ * @param data_vec Data as it was before the sort
+ * @param renderer Renderer where the render happens
+ * @param overlay Text drawn over every frame, or nullptr
+ * @param pacing Target duration or rate of the playback
+ * @return true Every operation was played
+ * @return false The window was closed during the playback
+ */
+template <typename Source>
+bool play_source(Source &source, std::size_t total,
+                 std::vector<int> &data_vec, SDL_Renderer *renderer,
+                 text_overlay *overlay, const playback_pacing &pacing)
+{
+    if (data_vec.empty())
+        return true;
+
+    SDL_Rect viewport;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+
+    if (data_vec.size() > static_cast<std::size_t>(viewport.w))
+    {
+        lod_renderer columns{renderer, data_vec};
+
+        return play_through(source, total, data_vec, renderer, columns,
+                            overlay, pacing);
+    }
+
+    // Bars run from the row of their value to the bottom of the canvas,
+    // which is stretched over the whole window
+    int height{*std::ranges::max_element(data_vec) + 1};
+    bar_renderer bars{renderer, data_vec.size(), height};
+
+    return play_through(source, total, data_vec, renderer, bars, overlay,
+                        pacing);
+}
+
+/**
+ * @brief
+ * Replays the operations of a finished sort, starting from the data the
+ * sort received. Every frame applies as many operations as the pacing
+ * allows, so the playback length does not depend on the operation count.
+ * Space pauses, the right arrow steps one operation, and the up and down
+ * arrows double or halve the speed.
+ * @param log Operations recorded by the sort
+ * @param data_vec Data as it was before the sort
+ * @param renderer Renderer where the render happens
+ * @param overlay Text drawn over every frame, or nullptr
+ * @param pacing Target duration or rate of the playback
+ * @return true The whole log was played
+ * @return false The window was closed during the playback
+ */
+inline bool play(const operation_log &log, std::vector<int> data_vec,
+                 SDL_Renderer *renderer, text_overlay *overlay = nullptr,
+                 const playback_pacing &pacing = {})
+{
+    log_source source{log};
+
+    return play_source(source, log.size(), data_vec, renderer, overlay,
+                       pacing);
+}
+
+/**
+ * @brief
+ * Plays the operations of a sort running on another thread as they arrive
+ * through a queue. The count must be known up front (from a counted run)
+ * so the pacing can spread them over the target duration. Frames that find
+ * the queue short play fewer operations.
+ * @param queue Operations pushed by the sort
+ * @param total Number of operations the sort pushes
+ * @param data_vec Data as it was before the sort
+ * @param renderer Renderer where the render happens
+ * @param overlay Text drawn over every frame, or nullptr
+ * @param pacing Target duration or rate of the playback
+ * @return true Every operation was played
+ * @return false The window was closed during the playback
+ */
+inline bool play(operation_queue &queue, std::size_t total,
+                 std::vector<int> data_vec, SDL_Renderer *renderer,
+                 text_overlay *overlay = nullptr,
+                 const playback_pacing &pacing = {})
+{
+    return play_source(queue, total, data_vec, renderer, overlay, pacing);
+}
+
+/**
+ * @brief
+ * Plays a trace file from its first step. Besides the keys of every
+ * playback, home, page up, page down and the left arrow seek in the run,
+ * starting from the nearest keyframe.
+ * @param trace Trace of the sort
+ * @param renderer Renderer where the render happens
+ * @param overlay Text drawn over every frame, or nullptr
+ * @param pacing Target duration or rate of the playback
+ * @return true Every operation was played
+ * @return false The window was closed during the playback
+ */
+inline bool play(trace_reader &trace, SDL_Renderer *renderer,
+                 text_overlay *overlay = nullptr,
+                 const playback_pacing &pacing = {})
+{
+    std::vector<int> data_vec;
+
+    trace.seek(0, data_vec);
+
+    return play_source(trace, trace.operations(), data_vec, renderer,
+                       overlay, pacing);
+}
+
+#endif //! PLAYER_H
@@ -0,0 +1,510 @@
+/**
+ * @file profiler.h
+ * @author Carlos Salguero
+ * @brief Scoped timing zones collected in per-thread ring buffers
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Zones are only recorded when the build defines SORT_PROFILER (the CMake
+// option of the same name); otherwise the macros below expand to nothing
+#ifdef SORT_PROFILER
+inline constexpr bool profiler_enabled{true};
+#else
+inline constexpr bool profiler_enabled{false};
+#endif
+
+// Zones kept per thread; the oldest ones are overwritten
+inline constexpr std::size_t profile_ring_size{1 << 15};
+
+// Frames kept for the frame-time graph
+inline constexpr std::size_t profile_frame_count{120};
+
+// Zones told apart in the breakdown of a frame; the others count as other
+inline constexpr std::size_t profile_categories{6};
+
+/**
+ * @brief
+ * A timed zone. Times are in nanoseconds since the profiler started, and
+ * depth is the number of zones of the same thread the zone is nested in.
+ */
+struct profile_event
+{
+    const char *name;
+    std::uint64_t start;
+    std::uint64_t end;
+    std::uint32_t depth;
+};
+
+/**
+ * @brief
+ * Zones of one thread. Only the owner thread pushes, without locks or
+ * allocations; any thread can read them back. The slots are relaxed
+ * atomics, so a reader racing with the writer gets torn zones at worst,
+ * and those are detected and dropped.
+ */
+class profile_ring
+{
+public:
+    /**
+     * @brief
+     * Construct a new ring
+     * @param id Number of the thread in the trace
+     */
+    explicit profile_ring(std::uint32_t id)
+        : id{id}, slots{std::make_unique<slot[]>(profile_ring_size)}
+    {
+    }
+
+    profile_ring(const profile_ring &) = delete;
+    profile_ring &operator=(const profile_ring &) = delete;
+
+    /**
+     * @brief
+     * Appends a zone, overwriting the oldest one when the ring is full.
+     * Owner thread only.
+     * @param event Finished zone
+     */
+    void push(const profile_event &event) noexcept
+    {
+        auto index{written.load(std::memory_order_relaxed)};
+        auto &target{slots[index % profile_ring_size]};
+
+        // Pairs with the fence of read: a reader that sees any of the
+        // stores below also sees written at index or later, and knows the
+        // slot is being overwritten
+        std::atomic_thread_fence(std::memory_order_release);
+
+        target.name.store(event.name, std::memory_order_relaxed);
+        target.start.store(event.start, std::memory_order_relaxed);
+        target.end.store(event.end, std::memory_order_relaxed);
+        target.depth.store(event.depth, std::memory_order_relaxed);
+
+        written.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief
+     * Appends the zones pushed since a cursor to a vector and moves the
+     * cursor past them. Zones already overwritten are skipped, and so are
+     * the ones the writer overwrote while they were being copied.
+     * @param cursor Number of zones already read
+     * @param events Receives the zones, oldest first
+     */
+    void read(std::uint64_t &cursor, std::vector<profile_event> &events) const
+    {
+        auto end{written.load(std::memory_order_acquire)};
+        auto begin{std::max(cursor, oldest(end))};
+        auto first{events.size()};
+
+        for (auto index{begin}; index < end; ++index)
+        {
+            const auto &source{slots[index % profile_ring_size]};
+
+            events.push_back({source.name.load(std::memory_order_relaxed),
+                              source.start.load(std::memory_order_relaxed),
+                              source.end.load(std::memory_order_relaxed),
+                              source.depth.load(std::memory_order_relaxed)});
+        }
+
+        // Zones pushed meanwhile may have landed on the copied slots. A push
+        // in flight writes the slot of index written before it moves
+        // written on, so that slot is counted as torn too
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        auto valid{oldest(written.load(std::memory_order_relaxed) + 1)};
+
+        if (valid > begin)
+        {
+            auto torn{std::min(valid, end) - begin};
+
+            events.erase(events.begin() + static_cast<std::ptrdiff_t>(first),
+                         events.begin() +
+                             static_cast<std::ptrdiff_t>(first + torn));
+        }
+
+        cursor = end;
+    }
+
+    // Zones the owner thread is nested in; owner thread only
+    std::uint32_t depth{};
+
+    const std::uint32_t id;
+
+private:
+    struct slot
+    {
+        std::atomic<const char *> name{};
+        std::atomic<std::uint64_t> start{};
+        std::atomic<std::uint64_t> end{};
+        std::atomic<std::uint32_t> depth{};
+    };
+
+    /**
+     * @brief
+     * Index of the oldest zone still in the ring.
+     * @param end Zones pushed so far
+     * @return std::uint64_t Index of the oldest zone
+     */
+    static std::uint64_t oldest(std::uint64_t end)
+    {
+        return end > profile_ring_size ? end - profile_ring_size : 0;
+    }
+
+    std::unique_ptr<slot[]> slots;
+    std::atomic<std::uint64_t> written{};
+};
+
+/**
+ * @brief
+ * A frame of the render thread: when it started and ended, and the time
+ * spent in each category of top-level zones, in nanoseconds.
+ */
+struct profile_frame
+{
+    std::uint64_t start{};
+    std::uint64_t end{};
+    std::array<std::uint64_t, profile_categories> zones{};
+};
+
+/**
+ * @brief
+ * Rings of every thread that entered a zone, the frames of the render
+ * thread, and the export of the zones as a Chrome trace. Rings outlive
+ * their threads, so the zones of finished sorts can still be exported.
+ */
+class profiler
+{
+public:
+    /**
+     * @brief
+     * Profiler of the process.
+     * @return profiler& Shared profiler
+     */
+    static profiler &instance()
+    {
+        static profiler global;
+
+        return global;
+    }
+
+    /**
+     * @brief
+     * Time since the profiler started.
+     * @return std::uint64_t Nanoseconds
+     */
+    std::uint64_t now() const noexcept
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - epoch)
+                .count());
+    }
+
+    /**
+     * @brief
+     * Ring of the calling thread, registered the first time the thread
+     * enters a zone.
+     * @return profile_ring& Ring of the thread
+     */
+    profile_ring &ring()
+    {
+        thread_local std::shared_ptr<profile_ring> local{join()};
+
+        return *local;
+    }
+
+    /**
+     * @brief
+     * Names the calling thread in the trace.
+     * @param name Name of the thread
+     */
+    void name_thread(std::string name)
+    {
+        auto id{ring().id};
+        std::lock_guard lock{mutex};
+
+        names[id] = std::move(name);
+    }
+
+    /**
+     * @brief
+     * Ends the current frame of the calling thread, which must always be
+     * the render thread: the time of the top-level zones it entered since
+     * the previous frame is added up by name.
+     */
+    void mark_frame()
+    {
+        auto now_ns{now()};
+        auto &local{ring()};
+        profile_frame frame{last_frame ? last_frame : now_ns, now_ns, {}};
+
+        pending.clear();
+        local.read(frame_cursor, pending);
+
+        for (const auto &event : pending)
+        {
+            if (event.depth || event.end <= frame.start)
+                continue;
+
+            auto duration{event.end - std::max(event.start, frame.start)};
+            frame.zones[category(event.name)] += duration;
+        }
+
+        frames[frame_total % profile_frame_count] = frame;
+        ++frame_total;
+        last_frame = now_ns;
+    }
+
+    /**
+     * @brief
+     * Frames kept for the graph, oldest first.
+     * @return std::vector<profile_frame> Last frames
+     */
+    std::vector<profile_frame> recent_frames() const
+    {
+        auto count{std::min(frame_total, profile_frame_count)};
+        std::vector<profile_frame> recent;
+
+        recent.reserve(count);
+
+        for (auto index{frame_total - count}; index < frame_total; ++index)
+            recent.push_back(frames[index % profile_frame_count]);
+
+        return recent;
+    }
+
+    /**
+     * @brief
+     * Names of the categories of the frames, in the order they were first
+     * seen. The last category gathers every zone past the others.
+     * @return const std::vector<std::string>& Names of the categories
+     */
+    const std::vector<std::string> &frame_categories() const
+    {
+        return categories;
+    }
+
+    bool graph_visible() const { return visible; }
+
+    void toggle_graph() { visible = !visible; }
+
+    /**
+     * @brief
+     * Writes every zone still in the rings as a Chrome trace (the JSON
+     * format of chrome://tracing and Perfetto): one complete event per
+     * zone, and the names of the threads as metadata.
+     * @param path Trace file
+     */
+    void write_chrome_trace(const std::string &path) const
+    {
+        std::unique_ptr<std::FILE, int (*)(std::FILE *)> file{
+            std::fopen(path.c_str(), "w"), std::fclose};
+
+        if (!file)
+            throw std::system_error{errno, std::generic_category(), path};
+
+        std::lock_guard lock{mutex};
+        const char *separator{""};
+
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file.get());
+
+        for (std::size_t id{}; id < rings.size(); ++id)
+        {
+            std::fprintf(file.get(),
+                         "%s\n{\"ph\":\"M\",\"pid\":1,\"tid\":%zu,"
+                         "\"name\":\"thread_name\",\"args\":{\"name\":\"",
+                         separator, id);
+            write_escaped(file.get(), names[id].c_str());
+            std::fputs("\"}}", file.get());
+            separator = ",";
+
+            std::vector<profile_event> events;
+            std::uint64_t cursor{};
+
+            rings[id]->read(cursor, events);
+
+            for (const auto &event : events)
+            {
+                std::fputs(",\n{\"ph\":\"X\",\"pid\":1,\"tid\":", file.get());
+                std::fprintf(file.get(), "%zu,\"ts\":%.3f,\"dur\":%.3f,"
+                                         "\"name\":\"",
+                             id, event.start / 1e3,
+                             (event.end - event.start) / 1e3);
+                write_escaped(file.get(), event.name);
+                std::fputs("\"}", file.get());
+            }
+        }
+
+        std::fputs("\n]}\n", file.get());
+
+        if (std::fflush(file.get()) != 0 || std::ferror(file.get()))
+            throw std::system_error{errno, std::generic_category(), path};
+    }
+
+private:
+    profiler() : epoch{std::chrono::steady_clock::now()} {}
+
+    /**
+     * @brief
+     * Registers a ring for the calling thread.
+     * @return std::shared_ptr<profile_ring> Ring of the thread
+     */
+    std::shared_ptr<profile_ring> join()
+    {
+        std::lock_guard lock{mutex};
+        auto id{static_cast<std::uint32_t>(rings.size())};
+
+        rings.push_back(std::make_shared<profile_ring>(id));
+        names.push_back("thread " + std::to_string(id));
+
+        return rings.back();
+    }
+
+    /**
+     * @brief
+     * Category of a zone of the render thread, added the first time a
+     * name is seen while there is room left.
+     * @param name Name of the zone
+     * @return std::size_t Index of the category
+     */
+    std::size_t category(const char *name)
+    {
+        // Names are literals, but the same literal can live at several
+        // addresses, so they are compared by content
+        for (std::size_t index{}; index < categories.size(); ++index)
+        {
+            if (categories[index] == name)
+                return index;
+        }
+
+        if (categories.size() + 1 < profile_categories)
+        {
+            categories.push_back(name);
+
+            return categories.size() - 1;
+        }
+
+        if (categories.size() + 1 == profile_categories)
+            categories.push_back("other");
+
+        return profile_categories - 1;
+    }
+
+    /**
+     * @brief
+     * Writes a string inside JSON quotes.
+     * @param file Output file
+     * @param text String to escape
+     */
+    static void write_escaped(std::FILE *file, const char *text)
+    {
+        for (; *text; ++text)
+        {
+            auto character{static_cast<unsigned char>(*text)};
+
+            if (character == '"' || character == '\\')
+                std::fputc('\\', file);
+
+            if (character < 0x20)
+                std::fprintf(file, "\\u%04x", character);
+
+            else
+                std::fputc(character, file);
+        }
+    }
+
+    std::chrono::steady_clock::time_point epoch;
+
+    // Every ring and thread name, indexed by the id of the thread
+    mutable std::mutex mutex;
+    std::vector<std::shared_ptr<profile_ring>> rings;
+    std::vector<std::string> names;
+
+    // Frames of the render thread, only touched by that thread
+    std::uint64_t frame_cursor{};
+    std::uint64_t last_frame{};
+    std::size_t frame_total{};
+    std::vector<profile_event> pending;
+    std::vector<std::string> categories;
+    std::array<profile_frame, profile_frame_count> frames{};
+    bool visible{false};
+};
+
+/**
+ * @brief
+ * Times the scope it lives in and pushes it to the ring of its thread
+ * when the scope ends. Used through PROFILE_ZONE, which compiles to
+ * nothing without SORT_PROFILER.
+ */
+class profile_zone
+{
+public:
+    /**
+     * @brief
+     * Construct a new zone, entering it
+     * @param name Name of the zone, a string literal
+     */
+    explicit profile_zone(const char *name)
+        : local{profiler::instance().ring()}, name{name},
+          depth{local.depth++}, start{profiler::instance().now()}
+    {
+    }
+
+    profile_zone(const profile_zone &) = delete;
+    profile_zone &operator=(const profile_zone &) = delete;
+
+    ~profile_zone()
+    {
+        --local.depth;
+        local.push({name, start, profiler::instance().now(), depth});
+    }
+
+private:
+    profile_ring &local;
+    const char *name;
+    std::uint32_t depth;
+    std::uint64_t start;
+};
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef SORT_PROFILER
+// Times the rest of the enclosing scope
+#define PROFILE_ZONE(name) \
+    profile_zone PROFILE_CONCAT(profile_zone_, __LINE__) { name }
+
+// Names the calling thread in the trace
+#define PROFILE_THREAD(name) profiler::instance().name_thread(name)
+
+// Ends a frame of the render thread
+#define PROFILE_FRAME() profiler::instance().mark_frame()
+#else
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#define PROFILE_THREAD(name) static_cast<void>(0)
+#define PROFILE_FRAME() static_cast<void>(0)
+#endif
+
+#endif //! PROFILER_H
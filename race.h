@@ -0,0 +1,560 @@
+/**
+ * @file race.h
+ * @author Carlos Salguero
+ * @brief Several sorts racing on their own threads, side by side
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef RACE_H
+#define RACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+// Operations, memory of the copies and playback
+#include "operation_stream.h"
+#include "player.h"
+#include "scratch_buffer.h"
+
+constexpr std::size_t race_cache_line{64};
+
+// Operations buffered between each racer and the render thread
+constexpr std::size_t race_stream_capacity{1 << 16};
+
+/**
+ * @brief
+ * Pins the calling thread to a core, so racers do not migrate between
+ * cores (and lose their caches) halfway through the race.
+ * @param core Index of the core, wrapped around the available cores
+ * @return true The thread was pinned
+ * @return false Pinning is not supported or was refused
+ */
+inline bool pin_to_core(unsigned int core)
+{
+#ifdef __linux__
+    unsigned int cores{std::max(std::thread::hardware_concurrency(), 1u)};
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(core % cores, &set);
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+
+    return false;
+#endif
+}
+
+/**
+ * @brief
+ * One algorithm of a race. Every lane starts on its own cache line, its
+ * copy of the data lives in its own cache line aligned block (first
+ * touched by the racer, on its core), and the live counters share a line
+ * with nothing that another racer writes.
+ */
+struct alignas(race_cache_line) race_lane
+{
+    race_lane(int option, std::string name)
+        : option{option}, name{std::move(name)}
+    {
+    }
+
+    int option;
+    std::string name;
+
+    // Copy of the data sorted by the racer
+    scratch_buffer memory;
+    std::span<int> data;
+
+    // Operations of the replay, streamed once the race is over
+    operation_queue queue{race_stream_capacity};
+
+    // Written by the racer, read by the render thread
+    alignas(race_cache_line) std::atomic<std::uint64_t> comparisons{};
+    std::atomic<std::uint64_t> swaps{};
+    std::atomic<std::uint64_t> writes{};
+    std::atomic<std::int64_t> elapsed_ns{};
+    std::atomic<bool> finished{false};
+
+    /**
+     * @brief
+     * Number of operations the replay streams, once the race is finished.
+     * @return std::uint64_t Operations of the sort
+     */
+    std::uint64_t operations() const
+    {
+        return comparisons.load(std::memory_order_relaxed) +
+               swaps.load(std::memory_order_relaxed) +
+               writes.load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief
+ * Recorder of a racing sort: it only publishes its counts, so the render
+ * thread can show them while the race runs. Each counter has a single
+ * writer, so a relaxed load and store replaces a locked increment.
+ */
+class race_recorder
+{
+public:
+    explicit race_recorder(race_lane &lane) : lane{lane} {}
+
+    void compare(std::size_t, std::size_t) { bump(lane.comparisons); }
+    void swap(std::size_t, std::size_t) { bump(lane.swaps); }
+
+    template <typename V>
+    void write(std::size_t, const V &) { bump(lane.writes); }
+
+private:
+    static void bump(std::atomic<std::uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    }
+
+    race_lane &lane;
+};
+
+using race_lanes = std::vector<std::unique_ptr<race_lane>>;
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Area of the window given to a lane: the lanes are laid out in a grid as
+ * close to square as possible, with a small gap between cells.
+ * @param renderer Renderer where the render happens
+ * @param index Index of the lane
+ * @param count Number of lanes
+ * @return SDL_Rect Viewport of the lane
+ */
+inline SDL_Rect race_viewport(SDL_Renderer *renderer, std::size_t index,
+                              std::size_t count)
+{
+    int output_width;
+    int output_height;
+
+    SDL_GetRendererOutputSize(renderer, &output_width, &output_height);
+
+    auto columns{static_cast<int>(
+        std::ceil(std::sqrt(static_cast<double>(count))))};
+    auto rows{static_cast<int>((count + columns - 1) / columns)};
+
+    int width{output_width / columns};
+    int height{output_height / rows};
+    int column{static_cast<int>(index) % columns};
+    int row{static_cast<int>(index) / columns};
+
+    return {column * width + 1, row * height + 1, std::max(width - 2, 1),
+            std::max(height - 2, 1)};
+}
+
+/**
+ * @brief
+ * Time a lane has been racing, or the time it took once finished.
+ * @param lane Lane of the race
+ * @param start When the race started
+ * @return double Milliseconds
+ */
+inline double race_time(const race_lane &lane,
+                        std::chrono::steady_clock::time_point start)
+{
+    if (lane.finished.load(std::memory_order_acquire))
+        return lane.elapsed_ns.load(std::memory_order_relaxed) / 1e6;
+
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+/**
+ * @brief
+ * Lines describing a lane: its name, its counters and its time.
+ * @param lane Lane of the race
+ * @param time Milliseconds raced
+ * @return std::vector<std::string> Lines of the description
+ */
+inline std::vector<std::string> race_lines(const race_lane &lane,
+                                           double time)
+{
+    char counts[96];
+    char clock[64];
+
+    std::snprintf(counts, sizeof(counts), "cmp %llu  swp %llu  wr %llu",
+                  static_cast<unsigned long long>(
+                      lane.comparisons.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(
+                      lane.swaps.load(std::memory_order_relaxed)),
+                  static_cast<unsigned long long>(
+                      lane.writes.load(std::memory_order_relaxed)));
+
+    std::snprintf(clock, sizeof(clock), "%s %.3f ms",
+                  lane.finished.load(std::memory_order_acquire) ? "finished in"
+                                                                : "running",
+                  time);
+
+    return {lane.name, counts, clock};
+}
+
+/**
+ * @brief
+ * Shows the live counters of every lane until all of them finish.
+ * @param lanes Lanes of the race
+ * @param renderer Renderer where the render happens
+ * @param start When the race started
+ * @return true Every lane finished
+ * @return false The window was closed during the race
+ */
+inline bool watch_race(const race_lanes &lanes, SDL_Renderer *renderer,
+                       std::chrono::steady_clock::time_point start)
+{
+    std::vector<text_overlay> boards(lanes.size());
+    frame_graph graph;
+
+    for (bool done{false}; !done;)
+    {
+        SDL_Event event;
+
+        {
+            PROFILE_ZONE("events");
+
+            while (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    return false;
+
+                if (event.type == SDL_KEYDOWN &&
+                    event.key.keysym.sym == SDLK_f && profiler_enabled)
+                    profiler::instance().toggle_graph();
+            }
+        }
+
+        {
+            PROFILE_ZONE("geometry");
+
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+
+            done = true;
+
+            for (std::size_t index{}; index < lanes.size(); ++index)
+            {
+                auto viewport{race_viewport(renderer, index, lanes.size())};
+                const auto &lane{*lanes[index]};
+
+                done = done && lane.finished.load(std::memory_order_acquire);
+
+                SDL_RenderSetViewport(renderer, &viewport);
+                boards[index].set_lines(
+                    race_lines(lane, race_time(lane, start)));
+                boards[index].draw(renderer);
+            }
+
+            SDL_RenderSetViewport(renderer, nullptr);
+            graph.draw(renderer);
+        }
+
+        {
+            PROFILE_ZONE("present");
+            SDL_RenderPresent(renderer);
+        }
+
+        if (!done)
+        {
+            PROFILE_ZONE("wait");
+            SDL_Delay(16);
+        }
+
+        PROFILE_FRAME();
+    }
+
+    return true;
+}
+
+/**
+ * @brief
+ * State of the replay of one lane on the render thread.
+ * @tparam View bar_renderer or lod_renderer
+ */
+template <typename View>
+struct lane_player
+{
+    std::vector<int> data;
+    std::unique_ptr<View> view;
+    text_overlay title;
+    text_overlay status{2, overlay_anchor::bottom_left};
+
+    std::uint64_t total{};
+    std::uint64_t played{};
+    std::uint64_t shortfall{};
+    std::uint64_t comparisons{};
+    std::uint64_t moves{};
+    std::size_t red{};
+    std::size_t blue{};
+};
+
+/**
+ * @brief
+ * Replays the lanes side by side, each in its own viewport, at the same
+ * rate of operations, so the lane with the fewest operations finishes
+ * first. Every lane streams from its racer, which runs the sort again.
+ * @tparam View bar_renderer or lod_renderer
+ * @tparam Make Callable that builds the view of a lane
+ * @param lanes Lanes of the race
+ * @param data_vec Data as it was before the race
+ * @param renderer Renderer where the render happens
+ * @param pacing Target duration or rate of the playback
+ * @param make_view Builds the view of a lane, inside its viewport
+ * @return true Every lane was played
+ * @return false The window was closed during the playback
+ */
+template <typename View, typename Make>
+bool play_lanes(const race_lanes &lanes, const std::vector<int> &data_vec,
+                SDL_Renderer *renderer, const playback_pacing &pacing,
+                Make make_view)
+{
+    std::vector<std::unique_ptr<lane_player<View>>> players;
+    std::uint64_t longest{};
+
+    for (std::size_t index{}; index < lanes.size(); ++index)
+    {
+        auto viewport{race_viewport(renderer, index, lanes.size())};
+        const auto &lane{*lanes[index]};
+        auto player{std::make_unique<lane_player<View>>()};
+        char raced[64];
+
+        SDL_RenderSetViewport(renderer, &viewport);
+
+        std::snprintf(raced, sizeof(raced), "raced in %.3f ms",
+                      lane.elapsed_ns.load(std::memory_order_relaxed) / 1e6);
+
+        player->data = data_vec;
+        player->view = make_view(player->data);
+        player->title.set_lines({lane.name, raced});
+        player->total = lane.operations();
+        player->red = player->blue = data_vec.size();
+
+        longest = std::max(longest, player->total);
+        players.push_back(std::move(player));
+    }
+
+    SDL_RenderSetViewport(renderer, nullptr);
+
+    frame_scheduler scheduler{longest, pacing};
+    text_overlay status{2, overlay_anchor::bottom_left};
+    frame_graph graph;
+
+    auto draw_lanes{[&](bool highlight)
+                    {
+                        // The gaps between the viewports stay gray
+                        SDL_SetRenderDrawColor(renderer, 64, 64, 64, 255);
+                        SDL_RenderClear(renderer);
+
+                        for (std::size_t index{}; index < players.size();
+                             ++index)
+                        {
+                            auto viewport{race_viewport(renderer, index,
+                                                        players.size())};
+                            auto &player{*players[index]};
+                            char counts[96];
+
+                            SDL_RenderSetViewport(renderer, &viewport);
+
+                            player.view->draw(
+                                player.data,
+                                highlight ? player.red : player.data.size(),
+                                highlight ? player.blue : player.data.size());
+
+                            std::snprintf(
+                                counts, sizeof(counts), "cmp %llu  mov %llu",
+                                static_cast<unsigned long long>(
+                                    player.comparisons),
+                                static_cast<unsigned long long>(player.moves));
+
+                            player.title.draw(renderer);
+                            player.status.set_lines({counts});
+                            player.status.draw(renderer);
+                        }
+
+                        SDL_RenderSetViewport(renderer, nullptr);
+                    }};
+
+    auto pending{[&]
+                 {
+                     return std::ranges::any_of(
+                         players, [](const auto &player)
+                         { return player->played < player->total; });
+                 }};
+
+    while (pending())
+    {
+        SDL_Event event;
+
+        {
+            PROFILE_ZONE("events");
+
+            while (SDL_PollEvent(&event))
+            {
+                if (event.type == SDL_QUIT)
+                    return false;
+
+                if (event.type == SDL_WINDOWEVENT &&
+                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                {
+                    for (std::size_t index{}; index < players.size();
+                         ++index)
+                    {
+                        auto viewport{race_viewport(renderer, index,
+                                                    players.size())};
+                        auto &player{*players[index]};
+
+                        SDL_RenderSetViewport(renderer, &viewport);
+
+                        if constexpr (requires { player.view->resize(
+                                                     player.data); })
+                            player.view->resize(player.data);
+
+                        else
+                            player.view->invalidate();
+                    }
+
+                    SDL_RenderSetViewport(renderer, nullptr);
+                }
+
+                if (event.type == SDL_KEYDOWN)
+                    control_playback(event.key.keysym.sym, scheduler);
+            }
+        }
+
+        // Every lane gets the same number of operations per frame; lanes
+        // whose racer has not streamed them yet catch up on later frames
+        {
+            PROFILE_ZONE("apply");
+
+            auto granted{scheduler.next_frame()};
+
+            for (std::size_t index{}; index < players.size(); ++index)
+            {
+                auto &player{*players[index]};
+                auto &view{*player.view};
+                auto want{std::min(granted + player.shortfall,
+                                   player.total - player.played)};
+
+                auto applied{lanes[index]->queue.consume(
+                    want, [&](const operation &op)
+                    {
+                        if constexpr (requires { view.apply(player.data,
+                                                            op); })
+                            view.apply(player.data, op);
+
+                        else
+                            apply_operation(player.data, op);
+
+                        if (op.kind == operation_kind::compare)
+                            ++player.comparisons;
+
+                        else
+                            ++player.moves;
+
+                        player.red = op.first;
+                        player.blue = op.kind == operation_kind::write
+                                          ? op.first
+                                          : op.second;
+                    })};
+
+                player.played += applied;
+                player.shortfall = want - applied;
+            }
+        }
+
+        {
+            PROFILE_ZONE("geometry");
+
+            draw_lanes(true);
+
+            status.set_lines({playback_status(scheduler, longest)});
+            status.draw(renderer);
+            graph.draw(renderer);
+        }
+
+        {
+            PROFILE_ZONE("present");
+            SDL_RenderPresent(renderer);
+        }
+
+        {
+            PROFILE_ZONE("wait");
+            scheduler.wait_for_frame();
+        }
+
+        PROFILE_FRAME();
+    }
+
+    draw_lanes(false);
+    SDL_RenderPresent(renderer);
+
+    return true;
+}
+
+/**
+ * @brief
+ * Replays a finished race with the renderer that fits the viewports of
+ * the lanes: one bar per element, or columns of elements.
+ * @param lanes Lanes of the race
+ * @param data_vec Data as it was before the race
+ * @param renderer Renderer where the render happens
+ * @param pacing Target duration or rate of the playback
+ * @return true Every lane was played
+ * @return false The window was closed during the playback
+ */
+inline bool play_race(const race_lanes &lanes,
+                      const std::vector<int> &data_vec,
+                      SDL_Renderer *renderer, const playback_pacing &pacing)
+{
+    if (lanes.empty() || data_vec.empty())
+        return true;
+
+    auto viewport{race_viewport(renderer, 0, lanes.size())};
+
+    if (data_vec.size() > static_cast<std::size_t>(viewport.w))
+        return play_lanes<lod_renderer>(
+            lanes, data_vec, renderer, pacing,
+            [&](const std::vector<int> &data)
+            { return std::make_unique<lod_renderer>(renderer, data); });
+
+    int height{*std::ranges::max_element(data_vec) + 1};
+
+    return play_lanes<bar_renderer>(
+        lanes, data_vec, renderer, pacing,
+        [&](const std::vector<int> &data)
+        {
+            return std::make_unique<bar_renderer>(renderer, data.size(),
+                                                  height);
+        });
+}
+
+#endif //! RACE_H
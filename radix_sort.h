@@ -0,0 +1,463 @@
+/**
+ * @file radix_sort.h
+ * @author Carlos Salguero
+ * @brief LSD and MSD radix sorts for integer and floating point keys
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+// Thread pool and scratch memory
+#include "thread_pool.h"
+#include "scratch_buffer.h"
+
+// Recorders and the phases reported to them
+#include "operation_counter.h"
+#include "sort_phase.h"
+
+/**
+ * @brief
+ * Keys handled by the radix sorts: 32 and 64-bit integers and IEEE floats.
+ */
+template <typename T>
+concept radix_sortable = (std::integral<T> || std::floating_point<T>) &&
+                         (sizeof(T) == 4 || sizeof(T) == 8);
+
+template <typename T>
+using radix_key_t =
+    std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+// Bits per digit, and the buckets of a digit
+constexpr unsigned int radix_bits{8};
+constexpr std::size_t radix_buckets{std::size_t{1} << radix_bits};
+
+// Inputs below this size are scattered by a single thread
+constexpr std::size_t radix_parallel_cutoff{1 << 16};
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Maps a value to an unsigned key with the same ordering. Signed integers
+ * get their sign bit flipped; negative floats get every bit flipped and
+ * positive floats only their sign bit. Descending sorts invert the key.
+ * @tparam Descending Whether the sort is descending
+ * @tparam T Type of the value
+ * @param value Value
+ * @return radix_key_t<T> Unsigned key
+ */
+template <bool Descending, radix_sortable T>
+radix_key_t<T> radix_key(T value)
+{
+    using key_type = radix_key_t<T>;
+    constexpr key_type sign{key_type{1} << (8 * sizeof(key_type) - 1)};
+
+    auto key{std::bit_cast<key_type>(value)};
+
+    if constexpr (std::floating_point<T>)
+        key = (key & sign) ? ~key : key | sign;
+
+    else if constexpr (std::is_signed_v<T>)
+        key ^= sign;
+
+    if constexpr (Descending)
+        key = ~key;
+
+    return key;
+}
+
+/**
+ * @brief
+ * Digit of a value at a given shift.
+ * @tparam Descending Whether the sort is descending
+ * @tparam T Type of the value
+ * @param value Value
+ * @param shift Position of the digit, in bits
+ * @return std::size_t Digit
+ */
+template <bool Descending, radix_sortable T>
+std::size_t radix_digit(T value, unsigned int shift)
+{
+    return static_cast<std::size_t>(
+        (radix_key<Descending>(value) >> shift) & (radix_buckets - 1));
+}
+
+/**
+ * @brief
+ * LSD radix sort of data[0, size), one pass per 8-bit digit. The histograms
+ * of every digit are built in a single parallel pass; digits where every
+ * key falls in the same bucket are skipped. Large passes are scattered in
+ * parallel: each thread owns a block and knows where each of its buckets
+ * starts, so the sort stays stable.
+ * @tparam Descending Whether the sort is descending
+ * @tparam T Type of the keys
+ * @param data First element
+ * @param size Number of elements
+ * @param pool Pool running the passes
+ * @param scratch Scratch memory, at least size elements
+ */
+template <bool Descending, radix_sortable T>
+void lsd_radix_sort(T *data, std::size_t size, work_stealing_pool &pool,
+                    scratch_buffer &scratch)
+{
+    constexpr std::size_t passes{sizeof(T) * 8 / radix_bits};
+    using histogram = std::array<std::size_t, radix_buckets>;
+
+    bool parallel{size >= radix_parallel_cutoff && pool.size() > 0};
+    std::size_t blocks{parallel ? pool.size() + 1 : 1};
+    std::size_t block_size{(size + blocks - 1) / blocks};
+
+    auto block_range{[&](std::size_t block)
+                     {
+                         std::size_t begin{std::min(block * block_size, size)};
+
+                         return std::pair{begin,
+                                          std::min(begin + block_size, size)};
+                     }};
+
+    // Histogram pass: every digit of every key, one read of the input
+    std::vector<std::array<histogram, passes>> partial(blocks);
+
+    pool.parallel_for(blocks,
+                      [&](std::size_t block)
+                      {
+                          auto &counts{partial[block]};
+                          auto [begin, end] = block_range(block);
+
+                          for (auto &pass : counts)
+                              pass.fill(0);
+
+                          for (std::size_t i{begin}; i < end; ++i)
+                          {
+                              auto key{radix_key<Descending>(data[i])};
+
+                              for (std::size_t pass{}; pass < passes; ++pass)
+                                  ++counts[pass][(key >> (pass * radix_bits)) &
+                                                 (radix_buckets - 1)];
+                          }
+                      });
+
+    T *from{data};
+    T *to{scratch.get<T>(size)};
+
+    std::vector<histogram> offsets(blocks);
+
+    for (std::size_t pass{}; pass < passes; ++pass)
+    {
+        unsigned int shift{static_cast<unsigned int>(pass * radix_bits)};
+
+        histogram total{};
+
+        for (const auto &counts : partial)
+        {
+            for (std::size_t bucket{}; bucket < radix_buckets; ++bucket)
+                total[bucket] += counts[pass][bucket];
+        }
+
+        // Every key has the same digit: the pass would not move anything
+        if (std::ranges::find(total, size) != total.end())
+            continue;
+
+        // Per block digit counts, in the current order of the data
+        if (parallel)
+        {
+            pool.parallel_for(blocks,
+                              [&](std::size_t block)
+                              {
+                                  auto [begin, end] = block_range(block);
+                                  offsets[block].fill(0);
+
+                                  for (std::size_t i{begin}; i < end; ++i)
+                                      ++offsets[block][radix_digit<Descending>(
+                                          from[i], shift)];
+                              });
+        }
+
+        else
+            offsets[0] = total;
+
+        std::size_t running{};
+
+        for (std::size_t bucket{}; bucket < radix_buckets; ++bucket)
+        {
+            for (auto &block : offsets)
+            {
+                std::size_t count{block[bucket]};
+                block[bucket] = running;
+                running += count;
+            }
+        }
+
+        pool.parallel_for(blocks,
+                          [&](std::size_t block)
+                          {
+                              auto [begin, end] = block_range(block);
+                              auto &next{offsets[block]};
+
+                              for (std::size_t i{begin}; i < end; ++i)
+                                  to[next[radix_digit<Descending>(
+                                      from[i], shift)]++] = from[i];
+                          });
+
+        std::swap(from, to);
+    }
+
+    if (from != data)
+    {
+        pool.parallel_for(blocks,
+                          [&](std::size_t block)
+                          {
+                              auto [begin, end] = block_range(block);
+                              std::memcpy(data + begin, from + begin,
+                                          (end - begin) * sizeof(T));
+                          });
+    }
+}
+
+/**
+ * @brief
+ * Orders handled by the recorded MSD radix sort: ascending or descending
+ * by the radix key of the projected value.
+ */
+template <typename Compare>
+concept radix_order = std::same_as<Compare, std::ranges::less> ||
+                      std::same_as<Compare, std::ranges::greater>;
+
+/**
+ * @brief
+ * In place MSD radix sort (American flag sort) of [first + begin,
+ * first + end), recording its operations. Every bucket is filled by
+ * swapping elements straight into place, so the whole run can be animated.
+ * Small buckets are finished with insertion sort.
+ * @tparam Descending Whether the sort is descending
+ * @tparam I Random access iterator
+ * @tparam Proj Projection giving the key of an element
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param begin First index of the range
+ * @param end One past the last index of the range
+ * @param shift Position of the current digit, in bits
+ * @param proj Projection giving the key of an element
+ * @param recorder Receives the operations of the sort
+ */
+template <bool Descending, std::random_access_iterator I, typename Proj,
+          sort_recorder Recorder>
+void msd_radix_range(I first, std::size_t begin, std::size_t end, int shift,
+                     Proj &proj, Recorder &recorder)
+{
+    auto key{[&](std::size_t index)
+             { return radix_key<Descending>(std::invoke(proj, first[index])); }};
+
+    auto digit_of{[&](std::size_t index)
+                  {
+                      return static_cast<std::size_t>(
+                          (key(index) >> shift) & (radix_buckets - 1));
+                  }};
+
+    std::array<std::size_t, radix_buckets> counts;
+
+    // Skip the leading digits shared by every key of the range
+    while (true)
+    {
+        if (end - begin <= 16)
+        {
+            for (std::size_t i{begin + 1}; i < end; ++i)
+            {
+                for (std::size_t j{i}; j > begin; --j)
+                {
+                    recorder.compare(j, j - 1);
+
+                    if (key(j) >= key(j - 1))
+                        break;
+
+                    std::ranges::iter_swap(first + j, first + (j - 1));
+                    recorder.swap(j, j - 1);
+                }
+            }
+
+            return;
+        }
+
+        counts.fill(0);
+
+        for (std::size_t i{begin}; i < end; ++i)
+            ++counts[digit_of(i)];
+
+        if (std::ranges::find(counts, end - begin) == counts.end())
+            break;
+
+        if (shift == 0)
+            return;
+
+        shift -= radix_bits;
+    }
+
+    std::array<std::size_t, radix_buckets> heads;
+    std::array<std::size_t, radix_buckets> tails;
+
+    std::size_t running{begin};
+
+    for (std::size_t bucket{}; bucket < radix_buckets; ++bucket)
+    {
+        heads[bucket] = running;
+        running += counts[bucket];
+        tails[bucket] = running;
+    }
+
+    // Swap every element into the next free slot of its bucket
+    begin_phase(recorder, sort_phase::scatter);
+
+    for (std::size_t bucket{}; bucket < radix_buckets; ++bucket)
+    {
+        while (heads[bucket] < tails[bucket])
+        {
+            auto digit{digit_of(heads[bucket])};
+
+            if (digit == bucket)
+            {
+                ++heads[bucket];
+                continue;
+            }
+
+            std::ranges::iter_swap(first + heads[bucket],
+                                   first + heads[digit]);
+            recorder.swap(heads[bucket], heads[digit]);
+            ++heads[digit];
+        }
+    }
+
+    end_phase(recorder, sort_phase::scatter);
+
+    if (shift == 0)
+        return;
+
+    std::size_t bucket_begin{begin};
+
+    for (std::size_t bucket{}; bucket < radix_buckets; ++bucket)
+    {
+        if (counts[bucket] > 1)
+            msd_radix_range<Descending>(first, bucket_begin,
+                                        bucket_begin + counts[bucket],
+                                        shift - radix_bits, proj, recorder);
+
+        bucket_begin += counts[bucket];
+    }
+}
+
+// Sort Functions
+/**
+ * @brief
+ * Radix Sort engine. LSD radix sort with a parallel histogram pass,
+ * skipping of trivial digits and a scratch buffer reused across calls.
+ * @tparam T Type of the keys
+ * @param data First element
+ * @param size Number of elements
+ * @param descending Whether the sort is descending
+ * @param pool Pool running the passes
+ * @param scratch Scratch memory reused across calls
+ */
+template <radix_sortable T>
+void radix_sort(T *data, std::size_t size, bool descending = false,
+                work_stealing_pool &pool = shared_pool(),
+                scratch_buffer &scratch = thread_scratch())
+{
+    if (size < 2)
+        return;
+
+    if (descending)
+        lsd_radix_sort<true>(data, size, pool, scratch);
+
+    else
+        lsd_radix_sort<false>(data, size, pool, scratch);
+}
+
+/**
+ * @brief
+ * Radix Sort engine over a vector.
+ * @tparam T Type of vector's data
+ * @param data_vec Vector with data to be sorted
+ * @param descending Whether the sort is descending
+ * @param pool Pool running the passes
+ * @param scratch Scratch memory reused across calls
+ */
+template <radix_sortable T>
+void radix_sort(std::vector<T> &data_vec, bool descending = false,
+                work_stealing_pool &pool = shared_pool(),
+                scratch_buffer &scratch = thread_scratch())
+{
+    radix_sort(data_vec.data(), data_vec.size(), descending, pool, scratch);
+}
+
+/**
+ * @brief
+ * Radix Sort Algorithm, in place MSD variant. Sorts [first, last) by the
+ * projected keys, ascending for std::ranges::less and descending for
+ * std::ranges::greater, and reports its operations to the recorder.
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare std::ranges::less or std::ranges::greater
+ * @tparam Proj Projection giving the key of an element
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param proj Projection giving the key of an element
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          radix_order Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::permutable<I> &&
+             radix_sortable<
+                 std::remove_cvref_t<std::indirect_result_t<Proj &, I>>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void msd_radix_sort(I first, S last, Compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
+{
+    using key_type = std::remove_cvref_t<std::indirect_result_t<Proj &, I>>;
+    constexpr bool descending{std::same_as<Compare, std::ranges::greater>};
+
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
+
+    if (size > 1)
+        msd_radix_range<descending>(first, 0, size,
+                                    8 * sizeof(key_type) - radix_bits, proj,
+                                    recorder);
+}
+
+/**
+ * @brief
+ * MSD Radix Sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          radix_order Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::permutable<std::ranges::iterator_t<R>> &&
+             radix_sortable<std::remove_cvref_t<
+                 std::indirect_result_t<Proj &, std::ranges::iterator_t<R>>>> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void msd_radix_sort(R &&range, Compare compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
+{
+    msd_radix_sort(std::ranges::begin(range), std::ranges::end(range),
+                   compare, std::move(proj), recorder);
+}
+
+#endif //! RADIX_SORT_H
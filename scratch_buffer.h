@@ -0,0 +1,137 @@
+/**
+ * @file scratch_buffer.h
+ * @author Carlos Salguero
+ * @brief Reusable scratch memory for the out-of-place sorts
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SCRATCH_BUFFER_H
+#define SCRATCH_BUFFER_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief
+ * Cache line aligned block of memory that only grows. Sorts that need an
+ * auxiliary array borrow it from here, so repeated runs do not allocate
+ * (and page fault) a fresh buffer every time. On Linux, large buffers are
+ * mapped directly and backed by transparent huge pages where available.
+ */
+class scratch_buffer
+{
+public:
+    scratch_buffer() = default;
+
+    scratch_buffer(const scratch_buffer &) = delete;
+    scratch_buffer &operator=(const scratch_buffer &) = delete;
+
+    ~scratch_buffer() { release(); }
+
+    /**
+     * @brief
+     * Returns room for count elements of type T. The contents are
+     * unspecified and are invalidated by the next call.
+     * @tparam T Trivially copyable element type
+     * @param count Number of elements
+     * @return T* First element
+     */
+    template <typename T>
+    T *get(std::size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "scratch memory holds trivially copyable data only");
+
+        reserve(count * sizeof(T));
+
+        return reinterpret_cast<T *>(memory);
+    }
+
+    /**
+     * @brief
+     * Grows the buffer to at least bytes.
+     * @param bytes Number of bytes
+     */
+    void reserve(std::size_t bytes)
+    {
+        if (bytes <= capacity)
+            return;
+
+        release();
+
+#ifdef __linux__
+        if (bytes >= huge_page)
+        {
+            void *address{::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+
+            if (address == MAP_FAILED)
+                throw std::bad_alloc{};
+
+            ::madvise(address, bytes, MADV_HUGEPAGE);
+
+            memory = static_cast<std::byte *>(address);
+            capacity = bytes;
+            mapped = true;
+
+            return;
+        }
+#endif
+
+        memory = static_cast<std::byte *>(
+            ::operator new(bytes, std::align_val_t{alignment}));
+        capacity = bytes;
+    }
+
+    /**
+     * @brief
+     * Frees the memory.
+     */
+    void release()
+    {
+        if (memory && !mapped)
+            ::operator delete(memory, std::align_val_t{alignment});
+
+#ifdef __linux__
+        if (memory && mapped)
+            ::munmap(memory, capacity);
+#endif
+
+        memory = nullptr;
+        capacity = 0;
+        mapped = false;
+    }
+
+    std::size_t size() const { return capacity; }
+
+private:
+    static constexpr std::size_t alignment{64};
+    static constexpr std::size_t huge_page{std::size_t{2} << 20};
+
+    std::byte *memory{nullptr};
+    std::size_t capacity{};
+    bool mapped{false};
+};
+
+/**
+ * @brief
+ * Scratch buffer of the calling thread.
+ * @return scratch_buffer& Buffer owned by the thread
+ */
+inline scratch_buffer &thread_scratch()
+{
+    static thread_local scratch_buffer scratch;
+
+    return scratch;
+}
+
+#endif //! SCRATCH_BUFFER_H
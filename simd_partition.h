@@ -0,0 +1,726 @@
+/**
+ * @file simd_partition.h
+ * @author Carlos Salguero
+ * @brief Branchless, vectorized partition kernels for primitive keys
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SIMD_PARTITION_H
+#define SIMD_PARTITION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SORTVIS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief
+ * Which elements go to the left side of a partition, relative to the pivot.
+ */
+enum class partition_kind
+{
+    less,
+    less_equal,
+    greater,
+    greater_equal
+};
+
+/**
+ * @brief
+ * Instruction set used by the partition kernels.
+ */
+enum class simd_level
+{
+    scalar,
+    avx2,
+    avx512
+};
+
+/**
+ * @brief
+ * Whether the vectorized kernels handle keys of type T sorted by Compare.
+ * Float keys must not be NaN.
+ */
+template <typename T, typename Compare>
+constexpr bool simd_partitionable{
+    (std::is_same_v<T, std::int32_t> || std::is_same_v<T, float> ||
+     std::is_same_v<T, std::uint64_t>) &&
+    (std::is_same_v<Compare, std::less<T>> ||
+     std::is_same_v<Compare, std::greater<T>>)};
+
+/**
+ * @brief
+ * Kind of partition equivalent to a comparator.
+ * @tparam T Type of the keys
+ * @tparam Compare std::less or std::greater
+ * @param or_equal Whether the keys equal to the pivot go to the left
+ * @return partition_kind Kind of partition
+ */
+template <typename T, typename Compare>
+constexpr partition_kind partition_kind_of(bool or_equal)
+{
+    if (std::is_same_v<Compare, std::less<T>>)
+        return or_equal ? partition_kind::less_equal : partition_kind::less;
+
+    return or_equal ? partition_kind::greater_equal : partition_kind::greater;
+}
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Whether a key goes to the left side of a partition.
+ * @tparam T Type of the keys
+ * @param value Key
+ * @param pivot Pivot
+ * @param kind Kind of partition
+ * @return true The key goes to the left
+ * @return false The key goes to the right
+ */
+template <typename T>
+inline bool goes_left(T value, T pivot, partition_kind kind)
+{
+    switch (kind)
+    {
+    case partition_kind::less:
+        return value < pivot;
+
+    case partition_kind::less_equal:
+        return !(pivot < value);
+
+    case partition_kind::greater:
+        return pivot < value;
+
+    case partition_kind::greater_equal:
+        return !(value < pivot);
+    }
+
+    return false;
+}
+
+/**
+ * @brief
+ * Scalar fallback: branchless Lomuto partition. Every element is swapped
+ * with the boundary unconditionally and the boundary only advances when the
+ * element belongs to the left, so there is no data dependent branch.
+ * @tparam T Type of the keys
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param pivot Pivot
+ * @param kind Kind of partition
+ * @return std::size_t Number of elements on the left side
+ */
+template <typename T>
+std::size_t scalar_partition(T *data, std::size_t size, T pivot,
+                             partition_kind kind)
+{
+    std::size_t left{};
+
+    auto run{[&](auto is_left)
+             {
+                 for (std::size_t i{}; i < size; ++i)
+                 {
+                     T value{data[i]};
+                     bool moves{is_left(value)};
+
+                     data[i] = data[left];
+                     data[left] = value;
+                     left += moves;
+                 }
+             }};
+
+    // The kind is resolved once, outside the loop
+    switch (kind)
+    {
+    case partition_kind::less:
+        run([pivot](T value) { return value < pivot; });
+        break;
+
+    case partition_kind::less_equal:
+        run([pivot](T value) { return !(pivot < value); });
+        break;
+
+    case partition_kind::greater:
+        run([pivot](T value) { return pivot < value; });
+        break;
+
+    case partition_kind::greater_equal:
+        run([pivot](T value) { return !(value < pivot); });
+        break;
+    }
+
+    return left;
+}
+
+#ifdef SORTVIS_X86_SIMD
+
+/**
+ * @brief
+ * Permutations that pack the selected lanes of an 8 x 32-bit vector into
+ * its low lanes, one per 8-bit mask. Each entry holds 8 lane indices.
+ */
+constexpr std::array<std::uint64_t, 256> make_compress_table_32()
+{
+    std::array<std::uint64_t, 256> table{};
+
+    for (unsigned int mask{}; mask < 256; ++mask)
+    {
+        std::uint64_t entry{};
+        unsigned int lane{};
+
+        for (unsigned int i{}; i < 8; ++i)
+        {
+            if (mask & (1u << i))
+                entry |= std::uint64_t{i} << (8 * lane++);
+        }
+
+        table[mask] = entry;
+    }
+
+    return table;
+}
+
+/**
+ * @brief
+ * Same as make_compress_table_32 for 4 x 64-bit lanes, expressed as pairs
+ * of 32-bit lane indices.
+ */
+constexpr std::array<std::uint64_t, 16> make_compress_table_64()
+{
+    std::array<std::uint64_t, 16> table{};
+
+    for (unsigned int mask{}; mask < 16; ++mask)
+    {
+        std::uint64_t entry{};
+        unsigned int lane{};
+
+        for (unsigned int i{}; i < 4; ++i)
+        {
+            if (mask & (1u << i))
+            {
+                entry |= std::uint64_t{2 * i} << (8 * lane++);
+                entry |= std::uint64_t{2 * i + 1} << (8 * lane++);
+            }
+        }
+
+        table[mask] = entry;
+    }
+
+    return table;
+}
+
+inline constexpr auto compress_table_32{make_compress_table_32()};
+inline constexpr auto compress_table_64{make_compress_table_64()};
+
+/**
+ * @brief
+ * AVX2 operations on keys of type T. mask returns one bit per lane that goes
+ * to the left; compress_store writes the selected lanes contiguously, and
+ * only those, so it never touches memory past them.
+ */
+template <typename T>
+struct avx2_ops;
+
+template <>
+struct avx2_ops<std::int32_t>
+{
+    using vector = __m256i;
+    static constexpr std::size_t width{8};
+
+    [[gnu::target("avx2")]] static vector load(const std::int32_t *data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    }
+
+    [[gnu::target("avx2")]] static vector broadcast(std::int32_t value)
+    {
+        return _mm256_set1_epi32(value);
+    }
+
+    [[gnu::target("avx2")]] static unsigned int mask(vector value,
+                                                      vector pivot,
+                                                      partition_kind kind)
+    {
+        bool below{kind == partition_kind::less ||
+                   kind == partition_kind::greater_equal};
+        bool negate{kind == partition_kind::less_equal ||
+                    kind == partition_kind::greater_equal};
+
+        __m256i lanes{below ? _mm256_cmpgt_epi32(pivot, value)
+                            : _mm256_cmpgt_epi32(value, pivot)};
+        auto bits{static_cast<unsigned int>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(lanes)))};
+
+        return negate ? ~bits & 0xFF : bits;
+    }
+
+    [[gnu::target("avx2")]] static void
+    compress_store(std::int32_t *destination, vector value, unsigned int mask)
+    {
+        auto indices{static_cast<long long>(compress_table_32[mask])};
+        __m256i permutation{_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(indices))};
+        __m256i lanes{_mm256_cmpgt_epi32(
+            _mm256_set1_epi32(__builtin_popcount(mask)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+
+        _mm256_maskstore_epi32(destination, lanes,
+                               _mm256_permutevar8x32_epi32(value,
+                                                           permutation));
+    }
+};
+
+template <>
+struct avx2_ops<float>
+{
+    using vector = __m256;
+    static constexpr std::size_t width{8};
+
+    [[gnu::target("avx2")]] static vector load(const float *data)
+    {
+        return _mm256_loadu_ps(data);
+    }
+
+    [[gnu::target("avx2")]] static vector broadcast(float value)
+    {
+        return _mm256_set1_ps(value);
+    }
+
+    [[gnu::target("avx2")]] static unsigned int mask(vector value,
+                                                      vector pivot,
+                                                      partition_kind kind)
+    {
+        switch (kind)
+        {
+        case partition_kind::less:
+            return static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(value, pivot, _CMP_LT_OQ)));
+
+        case partition_kind::less_equal:
+            return static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(value, pivot, _CMP_LE_OQ)));
+
+        case partition_kind::greater:
+            return static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(value, pivot, _CMP_GT_OQ)));
+
+        case partition_kind::greater_equal:
+            return static_cast<unsigned int>(
+                _mm256_movemask_ps(_mm256_cmp_ps(value, pivot, _CMP_GE_OQ)));
+        }
+
+        return 0;
+    }
+
+    [[gnu::target("avx2")]] static void
+    compress_store(float *destination, vector value, unsigned int mask)
+    {
+        auto indices{static_cast<long long>(compress_table_32[mask])};
+        __m256i permutation{_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(indices))};
+        __m256i lanes{_mm256_cmpgt_epi32(
+            _mm256_set1_epi32(__builtin_popcount(mask)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+
+        _mm256_maskstore_ps(destination, lanes,
+                            _mm256_permutevar8x32_ps(value, permutation));
+    }
+};
+
+template <>
+struct avx2_ops<std::uint64_t>
+{
+    using vector = __m256i;
+    static constexpr std::size_t width{4};
+
+    [[gnu::target("avx2")]] static vector load(const std::uint64_t *data)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    }
+
+    [[gnu::target("avx2")]] static vector broadcast(std::uint64_t value)
+    {
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+
+    [[gnu::target("avx2")]] static unsigned int mask(vector value,
+                                                      vector pivot,
+                                                      partition_kind kind)
+    {
+        // AVX2 only compares signed lanes: flip the sign bits first
+        __m256i bias{_mm256_set1_epi64x(INT64_MIN)};
+        value = _mm256_xor_si256(value, bias);
+        pivot = _mm256_xor_si256(pivot, bias);
+
+        bool below{kind == partition_kind::less ||
+                   kind == partition_kind::greater_equal};
+        bool negate{kind == partition_kind::less_equal ||
+                    kind == partition_kind::greater_equal};
+
+        __m256i lanes{below ? _mm256_cmpgt_epi64(pivot, value)
+                            : _mm256_cmpgt_epi64(value, pivot)};
+        auto bits{static_cast<unsigned int>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(lanes)))};
+
+        return negate ? ~bits & 0xF : bits;
+    }
+
+    [[gnu::target("avx2")]] static void
+    compress_store(std::uint64_t *destination, vector value, unsigned int mask)
+    {
+        auto indices{static_cast<long long>(compress_table_64[mask])};
+        __m256i permutation{_mm256_cvtepu8_epi32(_mm_cvtsi64_si128(indices))};
+        __m256i lanes{_mm256_cmpgt_epi64(
+            _mm256_set1_epi64x(__builtin_popcount(mask)),
+            _mm256_setr_epi64x(0, 1, 2, 3))};
+
+        _mm256_maskstore_epi64(reinterpret_cast<long long *>(destination),
+                               lanes,
+                               _mm256_permutevar8x32_epi32(value,
+                                                           permutation));
+    }
+};
+
+/**
+ * @brief
+ * AVX-512 operations on keys of type T, same interface as avx2_ops. The
+ * compare writes a mask register directly and the compress is a single
+ * instruction.
+ */
+template <typename T>
+struct avx512_ops;
+
+template <>
+struct avx512_ops<std::int32_t>
+{
+    using vector = __m512i;
+    static constexpr std::size_t width{16};
+
+    [[gnu::target("avx512f")]] static vector load(const std::int32_t *data)
+    {
+        return _mm512_loadu_si512(data);
+    }
+
+    [[gnu::target("avx512f")]] static vector broadcast(std::int32_t value)
+    {
+        return _mm512_set1_epi32(value);
+    }
+
+    [[gnu::target("avx512f")]] static unsigned int mask(vector value,
+                                                         vector pivot,
+                                                         partition_kind kind)
+    {
+        switch (kind)
+        {
+        case partition_kind::less:
+            return _mm512_cmp_epi32_mask(value, pivot, _MM_CMPINT_LT);
+
+        case partition_kind::less_equal:
+            return _mm512_cmp_epi32_mask(value, pivot, _MM_CMPINT_LE);
+
+        case partition_kind::greater:
+            return _mm512_cmp_epi32_mask(value, pivot, _MM_CMPINT_NLE);
+
+        case partition_kind::greater_equal:
+            return _mm512_cmp_epi32_mask(value, pivot, _MM_CMPINT_NLT);
+        }
+
+        return 0;
+    }
+
+    [[gnu::target("avx512f")]] static void
+    compress_store(std::int32_t *destination, vector value, unsigned int mask)
+    {
+        auto lanes{static_cast<__mmask16>((1u << __builtin_popcount(mask)) -
+                                          1)};
+
+        _mm512_mask_storeu_epi32(
+            destination, lanes,
+            _mm512_maskz_compress_epi32(static_cast<__mmask16>(mask), value));
+    }
+};
+
+template <>
+struct avx512_ops<float>
+{
+    using vector = __m512;
+    static constexpr std::size_t width{16};
+
+    [[gnu::target("avx512f")]] static vector load(const float *data)
+    {
+        return _mm512_loadu_ps(data);
+    }
+
+    [[gnu::target("avx512f")]] static vector broadcast(float value)
+    {
+        return _mm512_set1_ps(value);
+    }
+
+    [[gnu::target("avx512f")]] static unsigned int mask(vector value,
+                                                         vector pivot,
+                                                         partition_kind kind)
+    {
+        switch (kind)
+        {
+        case partition_kind::less:
+            return _mm512_cmp_ps_mask(value, pivot, _CMP_LT_OQ);
+
+        case partition_kind::less_equal:
+            return _mm512_cmp_ps_mask(value, pivot, _CMP_LE_OQ);
+
+        case partition_kind::greater:
+            return _mm512_cmp_ps_mask(value, pivot, _CMP_GT_OQ);
+
+        case partition_kind::greater_equal:
+            return _mm512_cmp_ps_mask(value, pivot, _CMP_GE_OQ);
+        }
+
+        return 0;
+    }
+
+    [[gnu::target("avx512f")]] static void
+    compress_store(float *destination, vector value, unsigned int mask)
+    {
+        auto lanes{static_cast<__mmask16>((1u << __builtin_popcount(mask)) -
+                                          1)};
+
+        _mm512_mask_storeu_ps(
+            destination, lanes,
+            _mm512_maskz_compress_ps(static_cast<__mmask16>(mask), value));
+    }
+};
+
+template <>
+struct avx512_ops<std::uint64_t>
+{
+    using vector = __m512i;
+    static constexpr std::size_t width{8};
+
+    [[gnu::target("avx512f")]] static vector load(const std::uint64_t *data)
+    {
+        return _mm512_loadu_si512(data);
+    }
+
+    [[gnu::target("avx512f")]] static vector broadcast(std::uint64_t value)
+    {
+        return _mm512_set1_epi64(static_cast<long long>(value));
+    }
+
+    [[gnu::target("avx512f")]] static unsigned int mask(vector value,
+                                                         vector pivot,
+                                                         partition_kind kind)
+    {
+        switch (kind)
+        {
+        case partition_kind::less:
+            return _mm512_cmp_epu64_mask(value, pivot, _MM_CMPINT_LT);
+
+        case partition_kind::less_equal:
+            return _mm512_cmp_epu64_mask(value, pivot, _MM_CMPINT_LE);
+
+        case partition_kind::greater:
+            return _mm512_cmp_epu64_mask(value, pivot, _MM_CMPINT_NLE);
+
+        case partition_kind::greater_equal:
+            return _mm512_cmp_epu64_mask(value, pivot, _MM_CMPINT_NLT);
+        }
+
+        return 0;
+    }
+
+    [[gnu::target("avx512f")]] static void
+    compress_store(std::uint64_t *destination, vector value, unsigned int mask)
+    {
+        auto lanes{static_cast<__mmask8>((1u << __builtin_popcount(mask)) -
+                                         1)};
+
+        _mm512_mask_storeu_epi64(
+            destination, lanes,
+            _mm512_maskz_compress_epi64(static_cast<__mmask8>(mask), value));
+    }
+};
+
+/*
+ * In place vectorized partition, shared by both instruction sets. The first
+ * and last vectors of the range are loaded up front, which leaves two
+ * vectors of free space. Every step then loads the next vector from the
+ * side with the least free space, compress-stores its left lanes at the
+ * left write position and its right lanes just below the right write
+ * position, so both stores always land on free space. The two saved
+ * vectors are distributed last, into the gap that remains.
+ *
+ * The body is written once and instantiated per instruction set, because a
+ * kernel must carry the target attribute of the intrinsics it inlines.
+ */
+#define SORTVIS_VECTOR_PARTITION(NAME, OPS, TARGET)                           \
+    template <typename T>                                                     \
+    [[gnu::target(TARGET)]] std::size_t NAME(T *data, std::size_t size,       \
+                                             T pivot_value,                   \
+                                             partition_kind kind)             \
+    {                                                                         \
+        using ops = OPS<T>;                                                   \
+        constexpr std::size_t width{ops::width};                              \
+        constexpr unsigned int all{(1u << width) - 1};                        \
+                                                                              \
+        if (size < 2 * width)                                                 \
+            return scalar_partition(data, size, pivot_value, kind);          \
+                                                                              \
+        auto pivot{ops::broadcast(pivot_value)};                              \
+        auto saved_left{ops::load(data)};                                     \
+        auto saved_right{ops::load(data + size - width)};                     \
+                                                                              \
+        std::size_t left{};                                                   \
+        std::size_t right{size};                                              \
+        std::size_t read_left{width};                                         \
+        std::size_t read_right{size - width};                                 \
+                                                                              \
+        while (read_right - read_left >= width)                               \
+        {                                                                     \
+            typename ops::vector value;                                       \
+                                                                              \
+            if (read_left - left <= right - read_right)                       \
+            {                                                                 \
+                value = ops::load(data + read_left);                          \
+                read_left += width;                                           \
+            }                                                                 \
+                                                                              \
+            else                                                              \
+            {                                                                 \
+                read_right -= width;                                          \
+                value = ops::load(data + read_right);                         \
+            }                                                                 \
+                                                                              \
+            unsigned int mask{ops::mask(value, pivot, kind)};                 \
+            std::size_t count{                                                \
+                static_cast<std::size_t>(__builtin_popcount(mask))};         \
+                                                                              \
+            ops::compress_store(data + left, value, mask);                    \
+            ops::compress_store(data + right - (width - count), value,        \
+                                ~mask & all);                                 \
+                                                                              \
+            left += count;                                                    \
+            right -= width - count;                                           \
+        }                                                                     \
+                                                                              \
+        /* Fewer than width unread elements are left in the middle */        \
+        while (read_left < read_right)                                        \
+        {                                                                     \
+            T value;                                                          \
+                                                                              \
+            if (read_left - left <= right - read_right)                       \
+                value = data[read_left++];                                    \
+                                                                              \
+            else                                                              \
+                value = data[--read_right];                                   \
+                                                                              \
+            if (goes_left(value, pivot_value, kind))                          \
+                data[left++] = value;                                         \
+                                                                              \
+            else                                                              \
+                data[--right] = value;                                        \
+        }                                                                     \
+                                                                              \
+        for (auto value : {saved_left, saved_right})                          \
+        {                                                                     \
+            unsigned int mask{ops::mask(value, pivot, kind)};                 \
+            std::size_t count{                                                \
+                static_cast<std::size_t>(__builtin_popcount(mask))};         \
+                                                                              \
+            ops::compress_store(data + left, value, mask);                    \
+            ops::compress_store(data + right - (width - count), value,        \
+                                ~mask & all);                                 \
+                                                                              \
+            left += count;                                                    \
+            right -= width - count;                                           \
+        }                                                                     \
+                                                                              \
+        return left;                                                          \
+    }
+
+SORTVIS_VECTOR_PARTITION(avx2_partition, avx2_ops, "avx2")
+SORTVIS_VECTOR_PARTITION(avx512_partition, avx512_ops, "avx512f")
+
+#undef SORTVIS_VECTOR_PARTITION
+
+#endif // SORTVIS_X86_SIMD
+
+/**
+ * @brief
+ * Best instruction set supported by the CPU.
+ * @return simd_level Detected level
+ */
+inline simd_level detect_simd_level()
+{
+#ifdef SORTVIS_X86_SIMD
+    if (__builtin_cpu_supports("avx512f"))
+        return simd_level::avx512;
+
+    if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+#endif
+
+    return simd_level::scalar;
+}
+
+/**
+ * @brief
+ * Instruction set used by simd_partition. Starts at the best one the CPU
+ * supports and can be lowered, e.g. to compare kernels in the benchmark.
+ */
+inline std::atomic<simd_level> active_simd_level{detect_simd_level()};
+
+/**
+ * @brief
+ * Selects the instruction set of the kernels, clamped to what the CPU
+ * supports.
+ * @param level Requested level
+ */
+inline void set_simd_level(simd_level level)
+{
+    active_simd_level = std::min(level, detect_simd_level());
+}
+
+// Partition Functions
+/**
+ * @brief
+ * Partitions data[0, size) in place so the keys that go to the left side
+ * (as given by kind) come first. Picks the AVX-512, AVX2 or scalar kernel
+ * at run time.
+ * @tparam T std::int32_t, float or std::uint64_t
+ * @param data First element of the range
+ * @param size Number of elements
+ * @param pivot Pivot
+ * @param kind Kind of partition
+ * @return std::size_t Number of elements on the left side
+ */
+template <typename T>
+std::size_t simd_partition(T *data, std::size_t size, T pivot,
+                           partition_kind kind)
+{
+#ifdef SORTVIS_X86_SIMD
+    switch (active_simd_level.load(std::memory_order_relaxed))
+    {
+    case simd_level::avx512:
+        return avx512_partition(data, size, pivot, kind);
+
+    case simd_level::avx2:
+        return avx2_partition(data, size, pivot, kind);
+
+    case simd_level::scalar:
+        break;
+    }
+#endif
+
+    return scalar_partition(data, size, pivot, kind);
+}
+
+#endif //! SIMD_PARTITION_H
@@ -0,0 +1,328 @@
+/**
+ * @file sort_file.cpp
+ * @author Carlos Salguero
+ * @brief Sorts a binary file of fixed-width keys through a memory mapping
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <optional>
+
+// Sorts
+#include "parallel_sorts.h"
+#include "radix_sort.h"
+
+// Memory mapped datasets
+#include "mapped_file.h"
+
+// Datasets larger than memory
+#include "external_sort.h"
+
+/**
+ * @brief
+ * Command line options of the tool.
+ */
+struct options
+{
+    std::string input;
+    std::string output;
+    std::string type{"i32"};
+    std::string algorithm{"radix"};
+    bool descending{false};
+    unsigned int threads{work_stealing_pool::default_workers() + 1};
+
+    // Memory cap in bytes of an external sort, 0 to sort through a mapping
+    std::size_t memory{};
+};
+
+// Function prototypes
+template <typename T>
+void external_sort_file(const options &, work_stealing_pool &);
+bool parse_options(int, char **, options &);
+void usage();
+
+/**
+ * @brief
+ * Milliseconds elapsed since a point in time.
+ * @param start Start of the measured phase
+ * @return double Milliseconds
+ */
+double elapsed_ms(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+/**
+ * @brief
+ * Sorts the keys of the input file, in place or into the output file.
+ * @tparam T Type of the keys
+ * @param opts Command line options
+ * @param pool Pool running the sort
+ */
+template <typename T>
+void sort_file(const options &opts, work_stealing_pool &pool)
+{
+    if (opts.memory)
+        return external_sort_file<T>(opts, pool);
+
+    auto start{std::chrono::steady_clock::now()};
+
+    // Without an output file the input is sorted in place. So is an output
+    // that names the input: creating it would truncate the keys first
+    std::error_code error;
+    bool in_place{opts.output.empty() ||
+                  std::filesystem::equivalent(opts.input, opts.output, error)};
+
+    mapped_file input{opts.input,
+                      in_place ? map_mode::read_write : map_mode::read_only};
+    std::optional<mapped_file> output;
+
+    auto keys{input.as<T>()};
+
+    // Load phase: stream the input in with full read-ahead
+    input.advise(access_pattern::sequential, true);
+
+    if (!in_place)
+    {
+        output.emplace(opts.output, map_mode::create, keys.size() * sizeof(T));
+        output->advise(access_pattern::sequential);
+
+        auto source{keys};
+        keys = output->as<T>();
+
+        std::size_t blocks{pool.size() + 1};
+        std::size_t block_size{(keys.size() + blocks - 1) / blocks};
+
+        pool.parallel_for(blocks,
+                          [&](std::size_t block)
+                          {
+                              std::size_t begin{
+                                  std::min(block * block_size, keys.size())};
+                              std::size_t end{std::min(begin + block_size,
+                                                       keys.size())};
+
+                              std::memcpy(keys.data() + begin,
+                                          source.data() + begin,
+                                          (end - begin) * sizeof(T));
+                          });
+
+        input.advise(access_pattern::normal);
+    }
+
+    const mapped_file &target{output ? *output : input};
+    double load{elapsed_ms(start)};
+
+    // Sort phase: radix and merge passes stream through the keys, quick
+    // sort jumps between the two ends of shrinking ranges
+    start = std::chrono::steady_clock::now();
+
+    if (opts.algorithm == "radix")
+    {
+        target.advise(access_pattern::sequential);
+        radix_sort(keys.data(), keys.size(), opts.descending, pool);
+    }
+
+    else if (opts.algorithm == "merge")
+    {
+        target.advise(access_pattern::sequential);
+
+        if (opts.descending)
+            parallel_merge_sort(keys.data(), keys.size(), std::greater<T>{},
+                                pool);
+
+        else
+            parallel_merge_sort(keys.data(), keys.size(), std::less<T>{},
+                                pool);
+    }
+
+    else
+    {
+        target.advise(access_pattern::random);
+
+        if (opts.descending)
+            parallel_quick_sort(keys.data(), keys.size(), std::greater<T>{},
+                                pool);
+
+        else
+            parallel_quick_sort(keys.data(), keys.size(), std::less<T>{},
+                                pool);
+    }
+
+    target.advise(access_pattern::normal);
+    double sort{elapsed_ms(start)};
+
+    std::cout << "Sorted " << keys.size() << " keys (" << opts.type
+              << ") with " << opts.algorithm << ": load " << load
+              << " ms, sort " << sort << " ms, "
+              << keys.size() / std::max(sort, 1e-3) / 1e3
+              << " M keys/s" << std::endl;
+}
+
+/**
+ * @brief
+ * Sorts the keys of the input file out of core, within the memory cap, in
+ * place or into the output file.
+ * @tparam T Type of the keys
+ * @param opts Command line options
+ * @param pool Pool sorting the runs
+ */
+template <typename T>
+void external_sort_file(const options &opts, work_stealing_pool &pool)
+{
+    auto start{std::chrono::steady_clock::now()};
+    const auto &output{opts.output.empty() ? opts.input : opts.output};
+
+    external_sort_options limits{opts.memory, {}};
+    external_progress progress;
+
+    if (opts.descending)
+        external_sort<T>(opts.input, output, limits, std::greater<T>{}, pool,
+                         &progress);
+
+    else
+        external_sort<T>(opts.input, output, limits, std::less<T>{}, pool,
+                         &progress);
+
+    double sort{elapsed_ms(start)};
+    auto keys{progress.keys.load()};
+
+    std::cout << "Sorted " << keys << " keys (" << opts.type
+              << ") out of core: " << progress.runs.load() << " runs, "
+              << progress.passes.load() << " merge passes, " << sort
+              << " ms, " << keys / std::max(sort, 1e-3) / 1e3
+              << " M keys/s" << std::endl;
+}
+
+// Main function
+int main(int argc, char **argv)
+{
+    options opts;
+
+    if (!parse_options(argc, argv, opts))
+    {
+        usage();
+
+        return EXIT_FAILURE;
+    }
+
+    work_stealing_pool pool{opts.threads - 1};
+
+    try
+    {
+        if (opts.type == "i32")
+            sort_file<std::int32_t>(opts, pool);
+
+        else if (opts.type == "u32")
+            sort_file<std::uint32_t>(opts, pool);
+
+        else if (opts.type == "i64")
+            sort_file<std::int64_t>(opts, pool);
+
+        else if (opts.type == "u64")
+            sort_file<std::uint64_t>(opts, pool);
+
+        else if (opts.type == "f32")
+            sort_file<float>(opts, pool);
+
+        else
+            sort_file<double>(opts, pool);
+    }
+
+    catch (const std::exception &error)
+    {
+        std::cerr << "Error: " << error.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// Function Declaration
+/**
+ * @brief
+ * Parses the command line.
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param opts Parsed options
+ * @return true The command line is valid
+ * @return false The command line is invalid
+ */
+bool parse_options(int argc, char **argv, options &opts)
+{
+    for (int i{1}; i < argc; ++i)
+    {
+        std::string arg{argv[i]};
+
+        if (arg == "--descending")
+            opts.descending = true;
+
+        else if (arg.rfind("--", 0) != 0)
+            opts.input = arg;
+
+        else if (i + 1 >= argc)
+            return false;
+
+        else if (arg == "--output")
+            opts.output = argv[++i];
+
+        else if (arg == "--type")
+            opts.type = argv[++i];
+
+        else if (arg == "--algorithm")
+            opts.algorithm = argv[++i];
+
+        else if (arg == "--threads")
+            opts.threads = std::max(std::atoi(argv[++i]), 1);
+
+        else if (arg == "--memory")
+        {
+            double megabytes{std::atof(argv[++i])};
+
+            if (megabytes < 1)
+                return false;
+
+            opts.memory = static_cast<std::size_t>(megabytes * (1 << 20));
+        }
+
+        else
+            return false;
+    }
+
+    bool valid_type{opts.type == "i32" || opts.type == "u32" ||
+                    opts.type == "i64" || opts.type == "u64" ||
+                    opts.type == "f32" || opts.type == "f64"};
+
+    return !opts.input.empty() && valid_type &&
+           (opts.algorithm == "radix" || opts.algorithm == "quick" ||
+            opts.algorithm == "merge");
+}
+
+/**
+ * @brief
+ * Shows the command line options.
+ */
+void usage()
+{
+    std::cerr
+        << "Usage: SortFile INPUT [options]\n"
+        << "  --output FILE            Sort into FILE instead of in place\n"
+        << "  --type i32|u32|i64|u64|f32|f64  Width and kind of the keys\n"
+        << "  --algorithm radix|quick|merge  Sorting engine (default radix)\n"
+        << "  --descending             Sort in descending order\n"
+        << "  --threads N              Threads of the sort\n"
+        << "  --memory MB              Sort out of core within MB of memory\n";
+}
@@ -0,0 +1,85 @@
+/**
+ * @file sort_phase.h
+ * @author Carlos Salguero
+ * @brief Phases of a sort, reported to recorders that measure them
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SORT_PHASE_H
+#define SORT_PHASE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief
+ * Phase of a sort: splitting a range around a pivot, merging sorted runs,
+ * or scattering keys into their buckets.
+ */
+enum class sort_phase : std::uint8_t
+{
+    partition,
+    merge,
+    scatter
+};
+
+constexpr std::size_t sort_phase_count{3};
+
+/**
+ * @brief
+ * Name of a phase, as used in the reports.
+ * @param phase Phase of a sort
+ * @return const char* Name of the phase
+ */
+inline const char *phase_name(sort_phase phase)
+{
+    switch (phase)
+    {
+    case sort_phase::partition:
+        return "partition";
+
+    case sort_phase::merge:
+        return "merge";
+
+    case sort_phase::scatter:
+        return "scatter";
+    }
+
+    return "unknown";
+}
+
+/**
+ * @brief
+ * Tells the recorder a phase starts. Recorders without phase hooks (the
+ * operation log, counter and null recorder) are left alone, so the call
+ * costs nothing for them.
+ * @tparam Recorder Any recorder
+ * @param recorder Receives the operations of the sort
+ * @param phase Phase that starts
+ */
+template <typename Recorder>
+void begin_phase(Recorder &recorder, sort_phase phase)
+{
+    if constexpr (requires { recorder.begin_phase(phase); })
+        recorder.begin_phase(phase);
+}
+
+/**
+ * @brief
+ * Tells the recorder a phase ends.
+ * @tparam Recorder Any recorder
+ * @param recorder Receives the operations of the sort
+ * @param phase Phase that ends
+ */
+template <typename Recorder>
+void end_phase(Recorder &recorder, sort_phase phase)
+{
+    if constexpr (requires { recorder.end_phase(phase); })
+        recorder.end_phase(phase);
+}
+
+#endif //! SORT_PHASE_H
@@ -0,0 +1,310 @@
+/**
+ * @file sorting_network.h
+ * @author Carlos Salguero
+ * @brief Sorting networks for small ranges, generated at compile time
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Recorders
+#include "operation_counter.h"
+
+// Largest range sorted by a network
+inline constexpr std::size_t network_limit{32};
+
+/**
+ * @brief
+ * Comparator of a network: the elements at first and second (first <
+ * second) are exchanged when they are out of order.
+ */
+struct network_pair
+{
+    std::uint8_t first;
+    std::uint8_t second;
+};
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Walks Batcher's odd-even merge sort network of the next power of two
+ * above size, in order, and hands out the comparators of the size first
+ * wires. The wires past size would hold elements greater than every other
+ * one, so the comparators that touch them never exchange and are left
+ * out.
+ * @tparam F Callable taking a network_pair
+ * @param size Number of wires
+ * @param function Receives every comparator
+ */
+template <typename F>
+constexpr void batcher_network(std::size_t size, F &&function)
+{
+    auto wires{std::bit_ceil(size)};
+
+    for (std::size_t p{1}; p < wires; p *= 2)
+    {
+        for (auto k{p}; k >= 1; k /= 2)
+        {
+            for (auto j{k % p}; j + k < wires; j += 2 * k)
+            {
+                for (std::size_t i{}; i < std::min(k, wires - j - k); ++i)
+                {
+                    auto low{i + j};
+                    auto high{i + j + k};
+
+                    if (low / (2 * p) != high / (2 * p) || high >= size)
+                        continue;
+
+                    function(network_pair{static_cast<std::uint8_t>(low),
+                                          static_cast<std::uint8_t>(high)});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * Number of comparators of the network of size wires.
+ * @param size Number of wires
+ * @return std::size_t Number of comparators
+ */
+constexpr std::size_t network_size(std::size_t size)
+{
+    std::size_t count{};
+
+    batcher_network(size, [&](network_pair) { ++count; });
+
+    return count;
+}
+
+/**
+ * @brief
+ * Comparators of the network that sorts N elements, in the order they
+ * apply. Comparators of the same layer are independent, which lets them
+ * run side by side.
+ * @tparam N Number of elements
+ * @return std::array<network_pair, network_size(N)> Comparators
+ */
+template <std::size_t N>
+constexpr std::array<network_pair, network_size(N)> make_network()
+{
+    std::array<network_pair, network_size(N)> pairs{};
+    std::size_t count{};
+
+    batcher_network(N, [&](network_pair pair) { pairs[count++] = pair; });
+
+    return pairs;
+}
+
+// Network of N elements, built once at compile time
+template <std::size_t N>
+    requires(N <= network_limit)
+inline constexpr auto sorting_network{make_network<N>()};
+
+/**
+ * @brief
+ * Whether small ranges of these elements are sorted by a network rather
+ * than by insertion sort: the values are small and trivially copyable, so
+ * the extra moves of the network cost less than the mispredicted branches
+ * of the insertion sort. The branchless path keeps them in a local array,
+ * so they must also be default constructible.
+ */
+template <typename I>
+concept network_sortable =
+    std::is_trivially_copyable_v<std::iter_value_t<I>> &&
+    std::default_initializable<std::iter_value_t<I>> &&
+    sizeof(std::iter_value_t<I>) <= 2 * sizeof(std::uint64_t);
+
+/**
+ * @brief
+ * Whether a network can run on copies of the elements, without a branch:
+ * the elements are network sortable and nothing is recorded.
+ */
+template <typename I, typename Recorder>
+concept branchless_exchange =
+    network_sortable<I> &&
+    std::same_as<std::remove_cvref_t<Recorder>, null_recorder>;
+
+/**
+ * @brief
+ * Whether elements that compare equal are interchangeable, so an unstable
+ * network can sort the runs of a stable sort: integers compared whole by
+ * the standard orderings.
+ */
+template <typename I, typename Compare, typename Proj>
+concept interchangeable_ties =
+    std::integral<std::iter_value_t<I>> &&
+    std::same_as<Proj, std::identity> &&
+    (std::same_as<Compare, std::ranges::less> ||
+     std::same_as<Compare, std::ranges::greater> ||
+     std::same_as<Compare, std::less<>> ||
+     std::same_as<Compare, std::greater<>> ||
+     std::same_as<Compare, std::less<std::iter_value_t<I>>> ||
+     std::same_as<Compare, std::greater<std::iter_value_t<I>>>);
+
+/**
+ * @brief
+ * Orders two elements. The smaller one is selected into a and the larger
+ * one into b, which compiles to conditional moves instead of a branch.
+ * @tparam T Type of the elements, small and trivially copyable
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @param a First element, receives the smaller one
+ * @param b Second element, receives the larger one
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ */
+template <typename T, typename Compare, typename Proj>
+constexpr void compare_exchange(T &a, T &b, Compare &compare, Proj &proj)
+{
+    T low{a};
+    T high{b};
+    bool exchange{std::invoke(compare, std::invoke(proj, high),
+                              std::invoke(proj, low))};
+
+    a = exchange ? high : low;
+    b = exchange ? low : high;
+}
+
+/**
+ * @brief
+ * Sorts [first + low, first + low + N) with the network of N elements,
+ * unrolled at compile time. With the null recorder, small trivially
+ * copyable elements are loaded once into local values the compiler keeps
+ * in registers, exchanged without branches, and stored back. Otherwise
+ * every comparator is a recorded compare and, when out of order, a swap.
+ * @tparam N Number of elements
+ * @tparam I Random access iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param low First index of the range
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::size_t N, std::random_access_iterator I, typename Compare,
+          typename Proj, sort_recorder Recorder>
+    requires(N <= network_limit)
+constexpr void network_sort_range(I first, std::size_t low,
+                                  Compare &compare, Proj &proj,
+                                  Recorder &recorder)
+{
+    constexpr auto &pairs{sorting_network<N>};
+
+    if constexpr (branchless_exchange<I, Recorder>)
+    {
+        std::array<std::iter_value_t<I>, N> values;
+
+        for (std::size_t i{}; i < N; ++i)
+            values[i] = first[low + i];
+
+        [&]<std::size_t... K>(std::index_sequence<K...>)
+        {
+            (compare_exchange(values[pairs[K].first], values[pairs[K].second],
+                              compare, proj),
+             ...);
+        }(std::make_index_sequence<pairs.size()>{});
+
+        for (std::size_t i{}; i < N; ++i)
+            first[low + i] = values[i];
+    }
+
+    else
+    {
+        for (auto [a, b] : pairs)
+        {
+            recorder.compare(low + b, low + a);
+
+            if (std::invoke(compare, std::invoke(proj, first[low + b]),
+                            std::invoke(proj, first[low + a])))
+            {
+                std::ranges::iter_swap(first + (low + a), first + (low + b));
+                recorder.swap(low + a, low + b);
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * Sorts the range [first + low, first + high) of at most Limit elements
+ * with the network of its size, picked at run time. Only the networks up
+ * to Limit are instantiated, which keeps the compile time of callers with
+ * smaller ranges down.
+ * @tparam Limit Largest size of the range
+ * @tparam I Random access iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param low First index of the range
+ * @param high End of the range
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::size_t Limit = network_limit, std::random_access_iterator I,
+          typename Compare, typename Proj, sort_recorder Recorder>
+    requires(Limit <= network_limit)
+constexpr void network_sort_range(I first, std::size_t low,
+                                  std::size_t high, Compare &compare,
+                                  Proj &proj, Recorder &recorder)
+{
+    using network_function = void (*)(I, std::size_t, Compare &, Proj &,
+                                      Recorder &);
+
+    // One function per size, each unrolled on its own
+    constexpr auto networks{
+        []<std::size_t... N>(std::index_sequence<N...>)
+        {
+            return std::array<network_function, sizeof...(N)>{
+                &network_sort_range<N, I, Compare, Proj, Recorder>...};
+        }(std::make_index_sequence<Limit + 1>{})};
+
+    networks[high - low](first, low, compare, proj, recorder);
+}
+
+// Sort Functions
+/**
+ * @brief
+ * Sorts a fixed-size array with its sorting network. Not stable.
+ * @tparam T Type of the elements
+ * @tparam N Number of elements, at most network_limit
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @param values Array to sort
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ */
+template <typename T, std::size_t N, typename Compare = std::ranges::less,
+          typename Proj = std::identity>
+    requires(N <= network_limit) &&
+            std::sortable<typename std::array<T, N>::iterator, Compare, Proj>
+constexpr void network_sort(std::array<T, N> &values, Compare compare = {},
+                            Proj proj = {})
+{
+    null_recorder recorder;
+
+    network_sort_range<N>(values.begin(), 0, compare, proj, recorder);
+}
+
+#endif //! SORTING_NETWORK_H
@@ -14,288 +14,1025 @@
 
 #include <vector>
 #include <algorithm>
-#include <cassert>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
+#include <ranges>
+#include <type_traits>
+#include <utility>
 
-// SDL Libraries
-#include <SDL2/SDL.h>
+// Recorders and the phases reported to them
+#include "operation_counter.h"
+#include "sort_phase.h"
+
+// Scratch memory of the merge sort
+#include "scratch_buffer.h"
+
+// Branchless base cases
+#include "sorting_network.h"
 
 // Auxiliary Functions
 /**
  * @brief
- * Draw the states of the sorting algorithm in the screen.
- * @param data_vec Vector with the data
- * @param renderer Renderer where the render happens
- * @param red Red color
- * @param blue Blue color
+ * Lomuto partition of [first + low, first + high] around the last element.
+ * @tparam I Random access iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param low First index of the range
+ * @param high Last index of the range (inclusive)
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ * @return std::size_t Final index of the pivot
  */
-void draw_states(std::vector<int> &data_vec, SDL_Renderer *renderer,
-                 unsigned int red, unsigned int blue)
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+std::size_t lomuto_partition(I first, std::size_t low, std::size_t high,
+                             Compare &compare, Proj &proj,
+                             Recorder &recorder)
 {
-    int index{};
+    auto i{low};
 
-    for (auto i : data_vec)
+    for (std::size_t j{low}; j < high; ++j)
     {
-        if (index == red)
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        recorder.compare(j, high);
 
-        else if (index == blue)
-            SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+        if (!std::invoke(compare, std::invoke(proj, first[high]),
+                         std::invoke(proj, first[j])))
+        {
+            std::ranges::iter_swap(first + i, first + j);
+            recorder.swap(i, j);
+            ++i;
+        }
+    }
 
-        else
-            SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    std::ranges::iter_swap(first + i, first + high);
+    recorder.swap(i, high);
 
-        SDL_RenderDrawLine(renderer, index, 99, index, i);
-        ++index;
-    }
+    return i;
 }
 
-// Sort Functions
 /**
  * @brief
- * Bubble Sort Algorithm (ascending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Quick Sort of the range [first + low, first + high]
+ * @tparam I Random access iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param low First index of the range
+ * @param high Last index of the range (inclusive)
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
  */
-template <typename T>
-void bubble_sort_ascending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+void quick_sort_range(I first, std::size_t low, std::size_t high,
+                      Compare &compare, Proj &proj, Recorder &recorder)
 {
-    for (unsigned int i{}; i < data_vec.size(); ++i)
+    if (low >= high)
+        return;
+
+    begin_phase(recorder, sort_phase::partition);
+    auto pivot{lomuto_partition(first, low, high, compare, proj, recorder)};
+    end_phase(recorder, sort_phase::partition);
+
+    if (pivot > low)
+        quick_sort_range(first, low, pivot - 1, compare, proj, recorder);
+
+    quick_sort_range(first, pivot + 1, high, compare, proj, recorder);
+}
+
+/**
+ * @brief
+ * Insertion sort of the range [first + low, first + high). With a limit
+ * the sort gives up once the elements moved that many places in total,
+ * which tells a nearly sorted range from one that is not.
+ * @tparam I Random access iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param low First index of the range
+ * @param high End of the range
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ * @param limit Places the elements may move before the sort gives up
+ * @return true The range is sorted
+ * @return false The limit was reached
+ */
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+bool insertion_sort_range(I first, std::size_t low, std::size_t high,
+                          Compare &compare, Proj &proj, Recorder &recorder,
+                          std::size_t limit = SIZE_MAX)
+{
+    std::size_t moves{};
+
+    for (std::size_t i{low + 1}; i < high; ++i)
     {
-        for (unsigned int j{}; j < data_vec.size() - 1; ++j)
-        {
-            if (data_vec.at(j) > data_vec.at(i))
-                std::swap(data_vec.at(j), data_vec.at(i));
+        // The element moves down through a hole instead of being swapped
+        // at every step; the recorded swaps replay to the same result
+        auto value{std::ranges::iter_move(first + i)};
+        std::size_t j{i};
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-            SDL_RenderClear(renderer);
+        for (; j > low; --j)
+        {
+            recorder.compare(j, j - 1);
 
-            draw_states(data_vec, renderer, i, j);
+            if (!std::invoke(compare, std::invoke(proj, value),
+                             std::invoke(proj, first[j - 1])))
+                break;
 
-            SDL_RenderPresent(renderer);
-            SDL_Delay(1);
+            first[j] = std::ranges::iter_move(first + (j - 1));
+            recorder.swap(j, j - 1);
         }
+
+        first[j] = std::move(value);
+        moves += i - j;
+
+        if (moves > limit)
+            return false;
     }
 
-    SDL_RenderClear(renderer);
+    return true;
 }
 
 /**
  * @brief
- * Bubble Sort Algorithm (descending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Moves the root of a heap down until both of its children are not
+ * greater. The heap holds size elements, starting at first + low.
+ * @param root Index of the root, relative to low
  */
-template <typename T>
-void bubble_sort_descending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+void sift_down(I first, std::size_t low, std::size_t root, std::size_t size,
+               Compare &compare, Proj &proj, Recorder &recorder)
 {
-    for (unsigned int i{}; i < data_vec.size(); ++i)
+    for (auto child{2 * root + 1}; child < size; child = 2 * root + 1)
     {
-        for (unsigned int j{}; j < data_vec.size() - 1; ++j)
+        if (child + 1 < size)
         {
-            if (data_vec.at(j) < data_vec.at(i))
-                std::swap(data_vec.at(i), data_vec.at(j));
+            recorder.compare(low + child, low + child + 1);
+
+            if (std::invoke(compare, std::invoke(proj, first[low + child]),
+                            std::invoke(proj, first[low + child + 1])))
+                ++child;
+        }
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-            SDL_RenderClear(renderer);
+        recorder.compare(low + root, low + child);
 
-            draw_states(data_vec, renderer, i, j);
+        if (!std::invoke(compare, std::invoke(proj, first[low + root]),
+                         std::invoke(proj, first[low + child])))
+            return;
 
-            SDL_RenderPresent(renderer);
-            SDL_Delay(1);
-        }
+        std::ranges::iter_swap(first + (low + root), first + (low + child));
+        recorder.swap(low + root, low + child);
+
+        root = child;
     }
+}
+
+/**
+ * @brief
+ * Heap sort of the range [first + low, first + high). O(n log n) whatever
+ * the input, which makes it the fallback of the hybrid sort.
+ */
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+void heap_sort_range(I first, std::size_t low, std::size_t high,
+                     Compare &compare, Proj &proj, Recorder &recorder)
+{
+    auto size{high - low};
+
+    for (auto root{size / 2}; root-- > 0;)
+        sift_down(first, low, root, size, compare, proj, recorder);
 
-    SDL_RenderClear(renderer);
+    for (auto end{size}; end-- > 1;)
+    {
+        std::ranges::iter_swap(first + low, first + (low + end));
+        recorder.swap(low, low + end);
+
+        sift_down(first, low, 0, end, compare, proj, recorder);
+    }
 }
 
 /**
  * @brief
- * Selection Sort Algorithm (ascending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Finishes a range that is already sorted, or sorted in reverse, in
+ * linear time. The scan stops at the first element out of order, so a
+ * range without a leading run costs a couple of comparisons.
+ * @return true The range is sorted
+ * @return false The range is not a single run
  */
-template <typename T>
-void selection_sort_ascending(std::vector<T> &data_vec,
-                              SDL_Renderer *renderer)
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+bool finish_run(I first, std::size_t low, std::size_t high,
+                Compare &compare, Proj &proj, Recorder &recorder)
 {
-    for (unsigned int i{}; i < data_vec.size() - 1; ++i)
+    auto ordered{[&](std::size_t left, std::size_t right)
+                 {
+                     recorder.compare(right, left);
+
+                     return !std::invoke(compare,
+                                         std::invoke(proj, first[right]),
+                                         std::invoke(proj, first[left]));
+                 }};
+
+    std::size_t i{low + 1};
+
+    while (i < high && ordered(i - 1, i))
+        ++i;
+
+    if (i == high)
+        return true;
+
+    if (i != low + 1)
+        return false;
+
+    // Descending run: every element is not less than the next one
+    while (i < high && ordered(i, i - 1))
+        ++i;
+
+    if (i != high)
+        return false;
+
+    for (auto left{low}, right{high - 1}; left < right; ++left, --right)
     {
-        auto min{i};
+        std::ranges::iter_swap(first + left, first + right);
+        recorder.swap(left, right);
+    }
+
+    return true;
+}
+
+/**
+ * @brief
+ * Orders three elements with three compare-exchanges.
+ */
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+void sort_three(I first, std::size_t a, std::size_t b, std::size_t c,
+                Compare &compare, Proj &proj, Recorder &recorder)
+{
+    auto exchange{[&](std::size_t left, std::size_t right)
+                  {
+                      recorder.compare(right, left);
 
-        for (unsigned int j{i + 1}; j < data_vec.size(); ++j)
+                      if (std::invoke(compare,
+                                      std::invoke(proj, first[right]),
+                                      std::invoke(proj, first[left])))
+                      {
+                          std::ranges::iter_swap(first + left,
+                                                 first + right);
+                          recorder.swap(left, right);
+                      }
+                  }};
+
+    exchange(a, b);
+    exchange(b, c);
+    exchange(a, b);
+}
+
+/**
+ * @brief
+ * Three-way (Dutch national flag) partition of [first + low, first + high)
+ * around the element at low. Keys equal to the pivot end up in the middle
+ * and are never looked at again, so few distinct keys cost a few passes.
+ * @return std::pair<std::size_t, std::size_t> Range of the keys equal to
+ * the pivot
+ */
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+std::pair<std::size_t, std::size_t>
+three_way_partition(I first, std::size_t low, std::size_t high,
+                    Compare &compare, Proj &proj, Recorder &recorder)
+{
+    // [low, less) < pivot, [less, i) == pivot, [greater, high) > pivot
+    auto less{low};
+    auto greater{high};
+
+    for (std::size_t i{low + 1}; i < greater;)
+    {
+        recorder.compare(i, less);
+
+        if (std::invoke(compare, std::invoke(proj, first[i]),
+                        std::invoke(proj, first[less])))
+        {
+            std::ranges::iter_swap(first + less, first + i);
+            recorder.swap(less, i);
+            ++less;
+            ++i;
+
+            continue;
+        }
+
+        recorder.compare(less, i);
+
+        if (std::invoke(compare, std::invoke(proj, first[less]),
+                        std::invoke(proj, first[i])))
         {
-            if (data_vec.at(j) < data_vec.at(min))
-                min = j;
+            --greater;
+            std::ranges::iter_swap(first + i, first + greater);
+            recorder.swap(i, greater);
         }
 
-        if (min != i)
-            std::swap(data_vec.at(min), data_vec.at(i));
+        else
+            ++i;
+    }
+
+    return {less, greater};
+}
+
+/**
+ * @brief
+ * Two-way partition of [first + low, first + high) around the element at
+ * low, scanning from both ends so every element is compared once. Keys
+ * equal to the pivot go to the right. The pivot must be a median, so that
+ * the scans meet an element that stops them.
+ * @return std::pair<std::size_t, bool> Final index of the pivot, and
+ * whether the range was already partitioned (no element had to move)
+ */
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+std::pair<std::size_t, bool>
+two_way_partition(I first, std::size_t low, std::size_t high,
+                  Compare &compare, Proj &proj, Recorder &recorder)
+{
+    auto less_than_pivot{[&](std::size_t i)
+                         {
+                             recorder.compare(i, low);
+
+                             return std::invoke(
+                                 compare, std::invoke(proj, first[i]),
+                                 std::invoke(proj, first[low]));
+                         }};
+
+    auto i{low};
+    auto j{high};
+
+    while (less_than_pivot(++i))
+        ;
+
+    // Without an element below the pivot nothing stops the right scan
+    if (i == low + 1)
+        while (i < j && !less_than_pivot(--j))
+            ;
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+    else
+        while (!less_than_pivot(--j))
+            ;
+
+    bool partitioned{i >= j};
+
+    while (i < j)
+    {
+        std::ranges::iter_swap(first + i, first + j);
+        recorder.swap(i, j);
 
-        draw_states(data_vec, renderer, i, min);
+        while (less_than_pivot(++i))
+            ;
 
-        SDL_RenderPresent(renderer);
-        SDL_Delay(10);
+        while (!less_than_pivot(--j))
+            ;
     }
 
-    SDL_RenderClear(renderer);
+    std::ranges::iter_swap(first + low, first + (i - 1));
+    recorder.swap(low, i - 1);
+
+    return {i - 1, partitioned};
 }
 
 /**
  * @brief
- * Selection Sort Algorithm (descending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Hybrid sort of the range [first + low, first + high), in the style of
+ * pdqsort: runs are finished in linear time, pivots are medians of three
+ * (ninthers on large ranges), and a lopsided partition shuffles a few
+ * elements to break the pattern that caused it. A pivot equal to the
+ * element before the range means the range is full of that key, so the
+ * equal keys are split off with a three-way partition and never visited
+ * again. Once too many partitions were lopsided the range falls back to
+ * heap sort, which bounds the worst case to O(n log n).
+ * @param bad_allowed Lopsided partitions left before falling back
  */
-template <typename T>
-void selection_sort_descending(std::vector<T> &data_vec,
-                               SDL_Renderer *renderer)
+template <std::random_access_iterator I, typename Compare, typename Proj,
+          sort_recorder Recorder>
+void hybrid_sort_range(I first, std::size_t low, std::size_t high,
+                       std::size_t bad_allowed, Compare &compare, Proj &proj,
+                       Recorder &recorder)
 {
-    for (unsigned int i{}; i < data_vec.size() - 1; ++i)
+    constexpr std::size_t insertion_limit{24};
+    constexpr std::size_t ninther_limit{128};
+    constexpr std::size_t nearly_sorted_moves{8};
+
+    auto swap_elements{[&](std::size_t left, std::size_t right)
+                       {
+                           std::ranges::iter_swap(first + left,
+                                                  first + right);
+                           recorder.swap(left, right);
+                       }};
+
+    // Swaps the elements the next pivot is picked from with elements a
+    // quarter of the way in, from both ends of the range
+    auto break_pattern{[&](std::size_t begin, std::size_t end)
+                       {
+                           auto size{end - begin};
+
+                           if (size <= insertion_limit)
+                               return;
+
+                           std::size_t picks{size > ninther_limit ? 3u : 1u};
+
+                           for (std::size_t k{}; k < picks; ++k)
+                           {
+                               swap_elements(begin + k, begin + size / 4 + k);
+                               swap_elements(end - 1 - k,
+                                             end - 1 - size / 4 - k);
+                           }
+                       }};
+
+    while (high - low > insertion_limit)
     {
-        auto max{i};
+        auto size{high - low};
+
+        if (finish_run(first, low, high, compare, proj, recorder))
+            return;
 
-        for (unsigned int j{i + 1}; j < data_vec.size(); ++j)
+        auto middle{low + size / 2};
+
+        if (size > ninther_limit)
         {
-            if (data_vec.at(j) > data_vec.at(max))
-                max = j;
+            sort_three(first, low, middle, high - 1, compare, proj,
+                       recorder);
+            sort_three(first, low + 1, middle - 1, high - 2, compare, proj,
+                       recorder);
+            sort_three(first, low + 2, middle + 1, high - 3, compare, proj,
+                       recorder);
+            sort_three(first, middle - 1, middle, middle + 1, compare, proj,
+                       recorder);
         }
 
-        if (max != i)
-            std::swap(data_vec.at(max), data_vec.at(i));
+        else
+            sort_three(first, low, middle, high - 1, compare, proj,
+                       recorder);
+
+        swap_elements(low, middle);
+
+        // Every element before the range is not greater than the ones in
+        // it, so a pivot that is not greater than its predecessor is the
+        // smallest key of the range
+        if (low > 0)
+        {
+            recorder.compare(low - 1, low);
+
+            if (!std::invoke(compare, std::invoke(proj, first[low - 1]),
+                             std::invoke(proj, first[low])))
+            {
+                begin_phase(recorder, sort_phase::partition);
+                auto equal_end{three_way_partition(first, low, high, compare,
+                                                   proj, recorder)
+                                   .second};
+                end_phase(recorder, sort_phase::partition);
+
+                low = equal_end;
+                continue;
+            }
+        }
+
+        begin_phase(recorder, sort_phase::partition);
+        auto [pivot, partitioned]{
+            two_way_partition(first, low, high, compare, proj, recorder)};
+        end_phase(recorder, sort_phase::partition);
+
+        auto left{pivot - low};
+        auto right{high - pivot - 1};
+
+        if (std::min(left, right) < size / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                heap_sort_range(first, low, pivot, compare, proj, recorder);
+                heap_sort_range(first, pivot + 1, high, compare, proj,
+                                recorder);
+                return;
+            }
 
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+            break_pattern(low, pivot);
+            break_pattern(pivot + 1, high);
+        }
 
-        draw_states(data_vec, renderer, i, max);
+        // Nothing moved around a central pivot: the range is likely close
+        // to sorted, which a bounded insertion sort finishes in linear time
+        else if (partitioned &&
+                 insertion_sort_range(first, low, pivot, compare, proj,
+                                      recorder, nearly_sorted_moves) &&
+                 insertion_sort_range(first, pivot + 1, high, compare, proj,
+                                      recorder, nearly_sorted_moves))
+            return;
 
-        SDL_RenderPresent(renderer);
-        SDL_Delay(10);
+        // Recursing into the smaller side bounds the stack to O(log n)
+        if (left < right)
+        {
+            hybrid_sort_range(first, low, pivot, bad_allowed, compare, proj,
+                              recorder);
+            low = pivot + 1;
+        }
+
+        else
+        {
+            hybrid_sort_range(first, pivot + 1, high, bad_allowed, compare,
+                              proj, recorder);
+            high = pivot;
+        }
     }
 
-    SDL_RenderClear(renderer);
+    // Small values take the branchless network; an insertion sort would
+    // mispredict about once per element on random data
+    if constexpr (network_sortable<I>)
+        network_sort_range<insertion_limit>(first, low, high, compare, proj,
+                                            recorder);
+
+    else
+        insertion_sort_range(first, low, high, compare, proj, recorder);
 }
 
 /**
  * @brief
- * Insertion Sort Algorithm (ascending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Merges the sorted runs [low, middle) and [middle, high) of source into
+ * the same positions of target. Ties are taken from the left run, which
+ * keeps the merge stable. Only writes into the sorted sequence are
+ * reported; while a pass writes into the scratch buffer, the sequence
+ * keeps its previous values.
+ * @tparam In Random access iterator of the runs
+ * @tparam Out Random access iterator of the merged run
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param source Sequence or scratch buffer holding the runs
+ * @param target Scratch buffer or sequence receiving the merged run
+ * @param low First index of the left run
+ * @param middle First index of the right run
+ * @param high End of the right run
+ * @param visible Whether target is the sorted sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
  */
-template <typename T>
-void insertion_sort_ascending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::random_access_iterator In, std::random_access_iterator Out,
+          typename Compare, typename Proj, sort_recorder Recorder>
+void merge_range(In source, Out target, std::size_t low, std::size_t middle,
+                 std::size_t high, bool visible, Compare &compare, Proj &proj,
+                 Recorder &recorder)
 {
-    for (unsigned int i{1}; i < data_vec.size(); ++i)
+    auto left{low};
+    auto right{middle};
+    auto position{low};
+
+    auto take{[&](std::size_t &from)
+              {
+                  target[position] = std::ranges::iter_move(source + from++);
+
+                  if (visible)
+                      recorder.write(position, target[position]);
+
+                  ++position;
+              }};
+
+    // Runs already in order are moved as they are: the left run continues
+    // into the right one
+    if (middle < high)
     {
-        for (unsigned int j{i};
-             j > 0 && data_vec.at(j) < data_vec.at(j - 1); --j)
+        recorder.compare(middle, middle - 1);
+
+        if (!std::invoke(compare, std::invoke(proj, source[middle]),
+                         std::invoke(proj, source[middle - 1])))
         {
-            std::swap(data_vec.at(j), data_vec.at(j - 1));
+            while (position < high)
+                take(left);
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-            SDL_RenderClear(renderer);
+            return;
+        }
+    }
 
-            draw_states(data_vec, renderer, i, j);
+    while (left < middle && right < high)
+    {
+        recorder.compare(right, left);
 
-            SDL_RenderPresent(renderer);
-            SDL_Delay(10);
-        }
+        if (std::invoke(compare, std::invoke(proj, source[right]),
+                        std::invoke(proj, source[left])))
+            take(right);
+
+        else
+            take(left);
     }
 
-    SDL_RenderClear(renderer);
+    // Whatever is left of one run follows in order
+    while (left < middle)
+        take(left);
+
+    while (right < high)
+        take(right);
 }
 
 /**
  * @brief
- * Insertion Sort Algorithm (descending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Bottom-up merge sort of [first, first + size) through a scratch buffer
+ * of the same size. Runs of at most 32 elements are sorted in place, by a
+ * sorting network for integer keys and by insertion sort otherwise, then
+ * every pass merges pairs of runs from the sequence into the buffer or
+ * back, so no pass allocates or copies back. The run length is size / 4^k
+ * rounded up, which makes the number of passes even: the last one lands in
+ * the sequence.
+ * @tparam I Random access iterator of the sequence
+ * @tparam Buffer Random access iterator of the scratch buffer
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element of the sequence
+ * @param scratch First element of the scratch buffer
+ * @param size Number of elements
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
  */
-template <typename T>
-void insertion_sort_descending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::random_access_iterator I, std::random_access_iterator Buffer,
+          typename Compare, typename Proj, sort_recorder Recorder>
+void merge_sort_passes(I first, Buffer scratch, std::size_t size,
+                       Compare &compare, Proj &proj, Recorder &recorder)
 {
-    for (unsigned int i{1}; i < data_vec.size(); ++i)
+    constexpr std::size_t run_limit{32};
+
+    auto width{size};
+
+    while (width > run_limit)
+        width = (width + 3) / 4;
+
+    // The network is not stable, so it only sorts the runs when equal
+    // elements cannot be told apart. It is not adaptive either: runs that
+    // are already in order, or reversed, are finished in linear time first
+    for (std::size_t low{}; low < size; low += width)
     {
-        for (unsigned int j{i};
-             j > 0 && data_vec.at(j) > data_vec.at(j - 1); --j)
+        auto high{std::min(low + width, size)};
+
+        if constexpr (interchangeable_ties<I, Compare, Proj>)
         {
-            std::swap(data_vec.at(j - 1), data_vec.at(j));
+            if (!finish_run(first, low, high, compare, proj, recorder))
+                network_sort_range<run_limit>(first, low, high, compare,
+                                              proj, recorder);
+        }
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-            SDL_RenderClear(renderer);
+        else
+            insertion_sort_range(first, low, high, compare, proj, recorder);
+    }
 
-            draw_states(data_vec, renderer, i, j);
+    auto pass{[&](auto source, auto target, std::size_t run, bool visible)
+              {
+                  for (std::size_t low{}; low < size; low += 2 * run)
+                      merge_range(source, target, low,
+                                  std::min(low + run, size),
+                                  std::min(low + 2 * run, size), visible,
+                                  compare, proj, recorder);
+              }};
 
-            SDL_RenderPresent(renderer);
-            SDL_Delay(10);
-        }
+    begin_phase(recorder, sort_phase::merge);
+
+    for (; width < size; width *= 4)
+    {
+        pass(first, scratch, width, false);
+        pass(scratch, first, 2 * width, true);
     }
 
-    SDL_RenderClear(renderer);
+    end_phase(recorder, sort_phase::merge);
 }
 
-template <typename T>
-T partition(std::vector<T> &data_vec, unsigned int low, unsigned int high)
+// Sort Functions
+/**
+ * @brief
+ * Bubble Sort Algorithm. Every algorithm of this file sorts [first, last)
+ * by compare applied to the projected elements, and reports its operations
+ * (as indices from first) to the recorder. The default null recorder
+ * compiles the reporting away.
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void bubble_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                 Recorder &&recorder = {})
 {
-    auto i{low - 1};
-    auto pivot = data_vec.at(high);
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
 
-    for (unsigned int j{low}; j < high; ++j)
+    for (std::size_t i{}; i < size; ++i)
     {
-        if (data_vec.at(j) <= pivot)
+        for (std::size_t j{}; j + 1 < size; ++j)
         {
-            ++i;
-            std::swap(data_vec.at(i), data_vec.at(j));
+            recorder.compare(i, j);
+
+            if (std::invoke(compare, std::invoke(proj, first[i]),
+                            std::invoke(proj, first[j])))
+            {
+                std::ranges::iter_swap(first + i, first + j);
+                recorder.swap(i, j);
+            }
         }
     }
+}
+
+/**
+ * @brief
+ * Selection Sort Algorithm
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void selection_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
+{
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
 
-    std::swap(data_vec.at(i + 1), data_vec.at(high));
+    for (std::size_t i{}; i + 1 < size; ++i)
+    {
+        auto best{i};
 
-    return i + 1;
+        for (std::size_t j{i + 1}; j < size; ++j)
+        {
+            recorder.compare(j, best);
+
+            if (std::invoke(compare, std::invoke(proj, first[j]),
+                            std::invoke(proj, first[best])))
+                best = j;
+        }
+
+        if (best != i)
+        {
+            std::ranges::iter_swap(first + best, first + i);
+            recorder.swap(i, best);
+        }
+    }
 }
 
 /**
  * @brief
- * Quick Sort Algorithm (ascending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Insertion Sort Algorithm
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
  */
-template <typename T>
-void quick_sort_ascending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void insertion_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
 {
-    auto low{0};
-    auto high{data_vec.size() - 1};
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
+
+    insertion_sort_range(first, 0, size, compare, proj, recorder);
+}
 
-    if (low < high)
+/**
+ * @brief
+ * Quick Sort Algorithm, Lomuto partition around the last element
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void quick_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                Recorder &&recorder = {})
+{
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
+
+    if (size > 1)
+        quick_sort_range(first, 0, size - 1, compare, proj, recorder);
+}
+
+/**
+ * @brief
+ * Hybrid Sort Algorithm: adapts to presorted input. Sorted and reversed
+ * runs take linear time, duplicated keys are partitioned three ways, and
+ * the worst case is O(n log n).
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void hybrid_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                 Recorder &&recorder = {})
+{
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
+
+    if (size > 1)
+        hybrid_sort_range(first, 0, size,
+                          static_cast<std::size_t>(std::bit_width(size)),
+                          compare, proj, recorder);
+}
+
+/**
+ * @brief
+ * Merge Sort Algorithm: stable, O(n log n) whatever the input. Elements
+ * that are trivially copyable ping-pong with the scratch buffer of the
+ * calling thread, which is reused from one sort to the next; others with
+ * one vector allocated for the whole sort. Writes into the sequence are
+ * reported to the recorder.
+ * @tparam I Random access iterator
+ * @tparam S Sentinel of the iterator
+ * @tparam Compare Ordering of the sort
+ * @tparam Proj Projection applied before comparing
+ * @tparam Recorder Operation log, counter or null recorder
+ * @param first First element
+ * @param last End of the sequence
+ * @param compare Ordering of the sort
+ * @param proj Projection applied before comparing
+ * @param recorder Receives the operations of the sort
+ */
+template <std::random_access_iterator I, std::sentinel_for<I> S,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<I, Compare, Proj> &&
+             (std::is_trivially_copyable_v<std::iter_value_t<I>> ||
+              std::default_initializable<std::iter_value_t<I>>) &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void merge_sort(I first, S last, Compare compare = {}, Proj proj = {},
+                Recorder &&recorder = {})
+{
+    using value_type = std::iter_value_t<I>;
+
+    auto size{static_cast<std::size_t>(std::ranges::distance(first, last))};
+
+    if (size < 2)
+        return;
+
+    if constexpr (std::is_trivially_copyable_v<value_type>)
+        merge_sort_passes(first, thread_scratch().get<value_type>(size), size,
+                          compare, proj, recorder);
+
+    else
     {
-        auto pivot = partition(data_vec, low, high);
+        std::vector<value_type> scratch(size);
 
-        quick_sort_ascending(data_vec, low, pivot - 1);
-        quick_sort_ascending(data_vec, pivot + 1, high);
+        merge_sort_passes(first, scratch.begin(), size, compare, proj,
+                          recorder);
     }
 }
 
+// Range Overloads
+/**
+ * @brief
+ * Bubble Sort of a whole range (vector, array, std::span...)
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void bubble_sort(R &&range, Compare compare = {}, Proj proj = {},
+                 Recorder &&recorder = {})
+{
+    bubble_sort(std::ranges::begin(range), std::ranges::end(range),
+                std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Selection Sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void selection_sort(R &&range, Compare compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
+{
+    selection_sort(std::ranges::begin(range), std::ranges::end(range),
+                   std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Insertion Sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void insertion_sort(R &&range, Compare compare = {}, Proj proj = {},
+                    Recorder &&recorder = {})
+{
+    insertion_sort(std::ranges::begin(range), std::ranges::end(range),
+                   std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Quick Sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void quick_sort(R &&range, Compare compare = {}, Proj proj = {},
+                Recorder &&recorder = {})
+{
+    quick_sort(std::ranges::begin(range), std::ranges::end(range),
+               std::move(compare), std::move(proj), recorder);
+}
+
+/**
+ * @brief
+ * Hybrid Sort of a whole range
+ */
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void hybrid_sort(R &&range, Compare compare = {}, Proj proj = {},
+                 Recorder &&recorder = {})
+{
+    hybrid_sort(std::ranges::begin(range), std::ranges::end(range),
+                std::move(compare), std::move(proj), recorder);
+}
+
 /**
  * @brief
- * Quick Sort Algorithm (descending)
- * @tparam T Type of vector's data
- * @param data_vec Vector with data to be rendered
- * @param renderer Renders the data into the window
+ * Merge Sort of a whole range
  */
-template <typename T>
-void quick_sort_descending(std::vector<T> &data_vec, SDL_Renderer *renderer)
+template <std::ranges::random_access_range R,
+          typename Compare = std::ranges::less,
+          typename Proj = std::identity, typename Recorder = null_recorder>
+    requires std::sortable<std::ranges::iterator_t<R>, Compare, Proj> &&
+             (std::is_trivially_copyable_v<std::ranges::range_value_t<R>> ||
+              std::default_initializable<std::ranges::range_value_t<R>>) &&
+             sort_recorder<std::remove_cvref_t<Recorder>>
+void merge_sort(R &&range, Compare compare = {}, Proj proj = {},
+                Recorder &&recorder = {})
 {
+    merge_sort(std::ranges::begin(range), std::ranges::end(range),
+               std::move(compare), std::move(proj), recorder);
 }
 
 #endif //! SORTS_H
@@ -0,0 +1,136 @@
+/**
+ * @file spsc_queue.h
+ * @author Carlos Salguero
+ * @brief Lock-free single producer, single consumer ring buffer
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief
+ * Bounded ring buffer shared by exactly one producer thread and one
+ * consumer thread. The positions only grow and are masked into the ring, so
+ * full and empty never look alike. Each side keeps a private copy of the
+ * other side's position and only reloads the shared atomic when that copy
+ * says the ring is full (or empty), which keeps the cache line of the other
+ * side from bouncing on every element. The two positions live on separate
+ * cache lines for the same reason.
+ * @tparam T Trivially copyable element
+ */
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class spsc_queue
+{
+public:
+    /**
+     * @brief
+     * Construct a new queue
+     * @param capacity Minimum number of elements, rounded up to a power of
+     * two
+     */
+    explicit spsc_queue(std::size_t capacity)
+        : mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1},
+          slots{std::make_unique<T[]>(mask + 1)}
+    {
+    }
+
+    spsc_queue(const spsc_queue &) = delete;
+    spsc_queue &operator=(const spsc_queue &) = delete;
+
+    /**
+     * @brief
+     * Appends an element. Producer side only.
+     * @param value Element to be appended
+     * @return true The element was appended
+     * @return false The queue is full
+     */
+    bool try_push(const T &value)
+    {
+        auto tail{producer.position.load(std::memory_order_relaxed)};
+
+        if (tail - producer.cached > mask)
+        {
+            producer.cached = consumer.position.load(std::memory_order_acquire);
+
+            if (tail - producer.cached > mask)
+                return false;
+        }
+
+        slots[tail & mask] = value;
+        producer.position.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * @brief
+     * Removes up to count elements in order, handing each one to a function.
+     * The consumer position is published once for the whole batch. Consumer
+     * side only.
+     * @tparam F Callable with a const T &
+     * @param count Maximum number of elements
+     * @param function Receives the elements
+     * @return std::size_t Number of elements removed
+     */
+    template <typename F>
+    std::size_t consume(std::size_t count, F &&function)
+    {
+        auto head{consumer.position.load(std::memory_order_relaxed)};
+
+        if (consumer.cached - head < count)
+            consumer.cached = producer.position.load(std::memory_order_acquire);
+
+        auto available{std::min(count, consumer.cached - head)};
+
+        for (std::size_t i{}; i < available; ++i)
+            function(slots[(head + i) & mask]);
+
+        if (available)
+            consumer.position.store(head + available,
+                                    std::memory_order_release);
+
+        return available;
+    }
+
+    /**
+     * @brief
+     * Number of elements the queue holds.
+     * @return std::size_t Capacity of the ring
+     */
+    std::size_t capacity() const { return mask + 1; }
+
+private:
+    static constexpr std::size_t cache_line{64};
+
+    /**
+     * @brief
+     * Position written by one side, and the last value of the other side's
+     * position it has seen.
+     */
+    struct alignas(cache_line) side
+    {
+        std::atomic<std::size_t> position{};
+        std::size_t cached{};
+    };
+
+    std::size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    side producer;
+    side consumer;
+};
+
+#endif //! SPSC_QUEUE_H
@@ -0,0 +1,301 @@
+/**
+ * @file text_overlay.h
+ * @author Carlos Salguero
+ * @brief Lines of text drawn over the visualization with a bitmap font
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TEXT_OVERLAY_H
+#define TEXT_OVERLAY_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// SDL Libraries
+#include <SDL2/SDL.h>
+
+// 5x7 glyph, one row per byte, the leftmost pixel in bit 4
+using glyph = std::array<std::uint8_t, 7>;
+
+constexpr int glyph_width{5};
+constexpr int glyph_height{7};
+
+// Auxiliary Functions
+/**
+ * @brief
+ * Bitmap of a character. Letters are drawn in upper case; characters
+ * without a glyph are drawn as blanks.
+ * @param character Character
+ * @return const glyph* Bitmap of the character, or nullptr
+ */
+inline const glyph *find_glyph(char character)
+{
+    static constexpr std::array<glyph, 10> digits{{
+        {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},
+        {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},
+        {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},
+        {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},
+        {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},
+        {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},
+        {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},
+        {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},
+    }};
+
+    static constexpr std::array<glyph, 26> letters{{
+        {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11},
+        {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},
+        {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},
+        {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},
+        {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},
+        {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},
+        {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},
+        {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},
+        {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},
+        {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},
+        {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},
+        {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},
+        {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},
+        {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},
+        {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},
+        {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},
+        {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},
+        {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},
+        {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},
+        {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04},
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},
+    }};
+
+    static constexpr std::array<std::pair<char, glyph>, 11> symbols{{
+        {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},
+        {',', {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}},
+        {':', {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},
+        {'%', {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},
+        {'-', {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},
+        {'+', {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},
+        {'=', {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}},
+        {'/', {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},
+        {'_', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}},
+        {'(', {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},
+        {')', {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},
+    }};
+
+    if (character >= '0' && character <= '9')
+        return &digits[character - '0'];
+
+    if (character >= 'A' && character <= 'Z')
+        return &letters[character - 'A'];
+
+    if (character >= 'a' && character <= 'z')
+        return &letters[character - 'a'];
+
+    for (const auto &[symbol, bitmap] : symbols)
+    {
+        if (symbol == character)
+            return &bitmap;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief
+ * Corner of the window an overlay is drawn in.
+ */
+enum class overlay_anchor
+{
+    top_left,
+    bottom_left,
+    top_right
+};
+
+/**
+ * @brief
+ * Lines of text in a corner of the viewport, over a dark box. The pixels of
+ * the text are turned into rects once, when the lines change, and
+ * submitted with a single SDL_RenderFillRects call per frame. The overlay
+ * is drawn in window pixels, whatever the scale of the renderer.
+ */
+class text_overlay
+{
+public:
+    /**
+     * @brief
+     * Construct a new text overlay
+     * @param scale Size in window pixels of a pixel of the font
+     * @param anchor Corner of the window
+     */
+    explicit text_overlay(int scale = 2,
+                          overlay_anchor anchor = overlay_anchor::top_left)
+        : scale{scale}, anchor{anchor}
+    {
+    }
+
+    /**
+     * @brief
+     * Replaces the text of the overlay.
+     * @param text Lines of text
+     */
+    void set_lines(std::vector<std::string> text)
+    {
+        if (text == lines)
+            return;
+
+        lines = std::move(text);
+        layout(top, left);
+    }
+
+    /**
+     * @brief
+     * Removes every line.
+     */
+    void clear() { set_lines({}); }
+
+    bool empty() const { return lines.empty(); }
+
+    /**
+     * @brief
+     * Box of the overlay as last drawn, in window pixels.
+     * @return SDL_Rect Box of the overlay
+     */
+    SDL_Rect bounds() const
+    {
+        return {left, top, width + 2 * margin, height + margin};
+    }
+
+    /**
+     * @brief
+     * Top left corner of the first character of a line, in window pixels.
+     * @param line Index of the line
+     * @return SDL_Point Corner of the line
+     */
+    SDL_Point line_origin(std::size_t line) const
+    {
+        return {left + margin, top + margin + static_cast<int>(line) *
+                                                 (glyph_height + 3) * scale};
+    }
+
+    /**
+     * @brief
+     * Draws the text into the current render target. Does not present.
+     * @param renderer Renderer where the render happens
+     */
+    void draw(SDL_Renderer *renderer)
+    {
+        if (lines.empty())
+            return;
+
+        float scale_x;
+        float scale_y;
+
+        SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+        SDL_RenderSetScale(renderer, 1, 1);
+
+        if (anchor != overlay_anchor::top_left)
+        {
+            SDL_Rect viewport;
+
+            SDL_RenderGetViewport(renderer, &viewport);
+
+            if (anchor == overlay_anchor::bottom_left &&
+                viewport.h - height - margin != top)
+                layout(viewport.h - height - margin, left);
+
+            if (anchor == overlay_anchor::top_right &&
+                viewport.w - width - 2 * margin != left)
+                layout(top, viewport.w - width - 2 * margin);
+        }
+
+        SDL_Rect box{bounds()};
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 192);
+        SDL_RenderFillRect(renderer, &box);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+        SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+
+        if (!pixels.empty())
+            SDL_RenderFillRects(renderer, pixels.data(),
+                                static_cast<int>(pixels.size()));
+
+        SDL_RenderSetScale(renderer, scale_x, scale_y);
+    }
+
+private:
+    static constexpr int margin{4};
+
+    /**
+     * @brief
+     * Turns the pixels of the text into rects.
+     * @param origin Top of the box, in window pixels
+     * @param offset Left of the box, in window pixels
+     */
+    void layout(int origin, int offset)
+    {
+        top = origin;
+        left = offset;
+        pixels.clear();
+        width = 0;
+
+        int advance{(glyph_width + 1) * scale};
+        int line_height{(glyph_height + 3) * scale};
+
+        for (std::size_t line{}; line < lines.size(); ++line)
+        {
+            int y{top + margin + static_cast<int>(line) * line_height};
+
+            for (std::size_t column{}; column < lines[line].size(); ++column)
+            {
+                const glyph *bitmap{find_glyph(lines[line][column])};
+
+                if (!bitmap)
+                    continue;
+
+                int x{left + margin + static_cast<int>(column) * advance};
+
+                for (int row{}; row < glyph_height; ++row)
+                {
+                    for (int bit{}; bit < glyph_width; ++bit)
+                    {
+                        if ((*bitmap)[row] & (0x10 >> bit))
+                            pixels.push_back({x + bit * scale,
+                                              y + row * scale, scale,
+                                              scale});
+                    }
+                }
+            }
+
+            width = std::max(width,
+                             static_cast<int>(lines[line].size()) * advance);
+        }
+
+        height = static_cast<int>(lines.size()) * line_height;
+    }
+
+    int scale;
+    overlay_anchor anchor;
+    int top{};
+    int left{};
+    int width{};
+    int height{};
+
+    std::vector<std::string> lines;
+    std::vector<SDL_Rect> pixels;
+};
+
+#endif //! TEXT_OVERLAY_H
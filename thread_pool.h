@@ -0,0 +1,266 @@
+/**
+ * @file thread_pool.h
+ * @author Carlos Salguero
+ * @brief Work-stealing thread pool used by the parallel sorts
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief
+ * Thread pool with one task deque per worker. A worker pushes and pops the
+ * tasks it spawns at the back of its own deque (newest first, which keeps
+ * its working set in cache) and, once it runs dry, steals the oldest task
+ * from the front of another worker's deque, which is usually the largest.
+ * Threads that wait for a group of tasks help running them instead of
+ * blocking.
+ */
+class work_stealing_pool
+{
+public:
+    /**
+     * @brief
+     * Construct a new work stealing pool
+     * @param workers Number of worker threads. The thread that waits on the
+     * pool also runs tasks, so one less than the number of cores is used.
+     */
+    explicit work_stealing_pool(unsigned int workers = default_workers())
+    {
+        for (unsigned int i{}; i < workers; ++i)
+            queues.push_back(std::make_unique<worker_queue>());
+
+        for (unsigned int i{}; i < workers; ++i)
+            threads.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    work_stealing_pool(const work_stealing_pool &) = delete;
+    work_stealing_pool &operator=(const work_stealing_pool &) = delete;
+
+    ~work_stealing_pool()
+    {
+        {
+            std::lock_guard lock{sleep_mutex};
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    /**
+     * @brief
+     * Number of worker threads.
+     * @return std::size_t Number of workers
+     */
+    std::size_t size() const { return queues.size(); }
+
+    /**
+     * @brief
+     * Queues a task. Workers push onto their own deque; other threads
+     * distribute their tasks round-robin.
+     * @param task Task to be run
+     */
+    void submit(std::function<void()> task)
+    {
+        if (queues.empty())
+        {
+            task();
+            return;
+        }
+
+        std::size_t index{current.pool == this
+                              ? current.index
+                              : next_queue++ % queues.size()};
+
+        {
+            std::lock_guard lock{queues[index]->mutex};
+            queues[index]->tasks.push_back(std::move(task));
+        }
+
+        ++queued;
+
+        {
+            std::lock_guard lock{sleep_mutex};
+        }
+
+        wake.notify_one();
+    }
+
+    /**
+     * @brief
+     * Runs queued tasks until pending drops to zero.
+     * @param pending Number of unfinished tasks of the group waited on
+     */
+    void wait(const std::atomic<std::size_t> &pending)
+    {
+        while (pending.load(std::memory_order_acquire) != 0)
+        {
+            if (!try_run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief
+     * Calls function(i) for every i in [0, count), spreading the calls over
+     * the pool, and returns once all of them are done.
+     * @tparam Function Callable taking an index
+     * @param count Number of calls
+     * @param function Function to be called
+     */
+    template <typename Function>
+    void parallel_for(std::size_t count, const Function &function)
+    {
+        std::atomic<std::size_t> pending{count > 0 ? count - 1 : 0};
+
+        for (std::size_t i{1}; i < count; ++i)
+        {
+            submit([&function, &pending, i]
+                   {
+                       function(i);
+                       pending.fetch_sub(1, std::memory_order_release);
+                   });
+        }
+
+        if (count > 0)
+            function(0);
+
+        wait(pending);
+    }
+
+    /**
+     * @brief
+     * Default number of workers: one less than the number of cores.
+     * @return unsigned int Number of workers
+     */
+    static unsigned int default_workers()
+    {
+        unsigned int cores{std::thread::hardware_concurrency()};
+
+        return cores > 1 ? cores - 1 : 0;
+    }
+
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct worker_identity
+    {
+        const work_stealing_pool *pool;
+        std::size_t index;
+    };
+
+    /**
+     * @brief
+     * Main loop of a worker thread.
+     * @param index Index of the worker
+     */
+    void worker_loop(std::size_t index)
+    {
+        current = {this, index};
+
+        while (true)
+        {
+            if (try_run_one())
+                continue;
+
+            std::unique_lock lock{sleep_mutex};
+            wake.wait(lock, [this] { return stopping || queued > 0; });
+
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+
+    /**
+     * @brief
+     * Runs one task: the newest one of the calling worker's own deque, or
+     * else the oldest one stolen from another deque.
+     * @return true A task was run
+     * @return false Every deque was empty
+     */
+    bool try_run_one()
+    {
+        std::function<void()> task;
+        bool own{current.pool == this};
+        std::size_t self{own ? current.index : 0};
+
+        if (own)
+        {
+            std::lock_guard lock{queues[self]->mutex};
+
+            if (!queues[self]->tasks.empty())
+            {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+            }
+        }
+
+        for (std::size_t i{1}; !task && i <= queues.size(); ++i)
+        {
+            auto &victim{*queues[(self + i) % queues.size()]};
+            std::lock_guard lock{victim.mutex};
+
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (!task)
+            return false;
+
+        --queued;
+        task();
+
+        return true;
+    }
+
+    std::vector<std::unique_ptr<worker_queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> queued{0};
+    std::atomic<std::size_t> next_queue{0};
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping{false};
+
+    // Zero initialized: threads outside any pool have no identity
+    static inline thread_local worker_identity current;
+};
+
+/**
+ * @brief
+ * Pool shared by every parallel sort of the program.
+ * @return work_stealing_pool& Shared pool
+ */
+inline work_stealing_pool &shared_pool()
+{
+    static work_stealing_pool pool;
+
+    return pool;
+}
+
+#endif //! THREAD_POOL_H
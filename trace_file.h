@@ -0,0 +1,527 @@
+/**
+ * @file trace_file.h
+ * @author Carlos Salguero
+ * @brief Compact binary trace of a sort run, with keyframes to seek in it
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TRACE_FILE_H
+#define TRACE_FILE_H
+
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+#include "operation_log.h"
+
+/*
+ * Layout of a trace file, in the byte order of the machine that wrote it:
+ *
+ *   header    trace_header
+ *   chunk 0   keyframe (every element, as int32), then encoded operations
+ *   chunk 1   ...
+ *   index     offset of every chunk from the start of the file (uint64)
+ *   footer    trace_footer
+ *
+ * Chunk k starts at step k * interval. The delta encoding starts over at
+ * every chunk, so decoding can begin at any of them.
+ */
+
+inline constexpr char trace_magic[8]{'S', 'O', 'R', 'T', 'T', 'R', 'C', '1'};
+inline constexpr std::uint32_t trace_version{1};
+
+/**
+ * @brief
+ * First bytes of a trace file.
+ */
+struct trace_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t elements;
+    std::uint64_t interval;
+};
+
+/**
+ * @brief
+ * Last bytes of a trace file. A file without it was not finished.
+ */
+struct trace_footer
+{
+    std::uint64_t steps;
+    std::uint64_t chunks;
+    std::uint64_t index_offset;
+    char magic[8];
+};
+
+/**
+ * @brief
+ * Variable length encoding of the operations of a chunk. Each index is
+ * stored as the distance from the same index of the previous operation of
+ * the same kind, and a written value as the distance from the previous
+ * written value. Sorts move their indices a step at a time and keep their
+ * pivot in place, so most operations take two or three bytes instead of
+ * nine.
+ */
+struct trace_codec
+{
+    // Unsigned, so the sums of a corrupt file wrap instead of overflowing
+    std::uint64_t first[3]{};
+    std::uint64_t second[3]{};
+
+    /**
+     * @brief
+     * Appends an operation to a buffer.
+     * @param op Operation to be encoded
+     * @param out Buffer of the encoded operations
+     */
+    void encode(const operation &op, std::vector<std::byte> &out)
+    {
+        auto kind{static_cast<std::size_t>(op.kind)};
+        std::uint64_t index{op.first};
+
+        // Written values are signed, indices are not
+        auto other{op.kind == operation_kind::write
+                       ? static_cast<std::uint64_t>(
+                             static_cast<std::int32_t>(op.second))
+                       : std::uint64_t{op.second}};
+
+        put(zigzag(index - first[kind]) << 2 | kind, out);
+        put(zigzag(other - second[kind]), out);
+
+        first[kind] = index;
+        second[kind] = other;
+    }
+
+    /**
+     * @brief
+     * Reads the operation at the cursor and moves past it.
+     * @param cursor Next encoded byte
+     * @param end End of the encoded bytes
+     * @return operation Decoded operation
+     */
+    operation decode(const std::byte *&cursor, const std::byte *end)
+    {
+        auto head{get(cursor, end)};
+        auto kind{head & 3};
+
+        if (kind > static_cast<std::uint64_t>(operation_kind::write))
+            throw std::runtime_error{"corrupt trace operation"};
+
+        first[kind] += unzigzag(head >> 2);
+        second[kind] += unzigzag(get(cursor, end));
+
+        return {static_cast<operation_kind>(kind),
+                static_cast<std::uint32_t>(first[kind]),
+                static_cast<std::uint32_t>(second[kind])};
+    }
+
+private:
+    // Small distances of either sign become small codes
+    static std::uint64_t zigzag(std::uint64_t delta)
+    {
+        return delta << 1 ^ (0 - (delta >> 63));
+    }
+
+    static std::uint64_t unzigzag(std::uint64_t code)
+    {
+        return code >> 1 ^ (0 - (code & 1));
+    }
+
+    static void put(std::uint64_t code, std::vector<std::byte> &out)
+    {
+        for (; code >= 0x80; code >>= 7)
+            out.push_back(static_cast<std::byte>(code | 0x80));
+
+        out.push_back(static_cast<std::byte>(code));
+    }
+
+    static std::uint64_t get(const std::byte *&cursor, const std::byte *end)
+    {
+        std::uint64_t code{};
+
+        for (int shift{}; shift < 64; shift += 7)
+        {
+            if (cursor == end)
+                break;
+
+            auto byte{static_cast<std::uint64_t>(*cursor++)};
+            code |= (byte & 0x7f) << shift;
+
+            if (!(byte & 0x80))
+                return code;
+        }
+
+        throw std::runtime_error{"truncated trace operation"};
+    }
+};
+
+/**
+ * @brief
+ * Recorder that writes a run to a trace file as it happens. It keeps its
+ * own copy of the data, applies every operation to it and stores it as a
+ * keyframe at the start of every chunk, so the file can be played from any
+ * step without replaying it from the start. Memory stays bounded by the
+ * data and a write buffer, whatever the length of the run. Errors are
+ * reported as std::system_error.
+ */
+class trace_writer
+{
+public:
+    /**
+     * @brief
+     * Construct a new trace writer
+     * @param path Path of the file, replaced if it exists
+     * @param data_vec Data as it is before the sort
+     * @param interval Operations between keyframes, or 0 for four per
+     * element, where the keyframes take about a byte per operation
+     */
+    trace_writer(const std::string &path, std::span<const int> data_vec,
+                 std::size_t interval = 0)
+        : state(data_vec.begin(), data_vec.end()),
+          interval{interval ? interval
+                            : std::max(min_interval, 4 * data_vec.size())}
+    {
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if (descriptor < 0)
+            fail("could not open " + path);
+
+        trace_header header{};
+
+        std::memcpy(header.magic, trace_magic, sizeof(trace_magic));
+        header.version = trace_version;
+        header.elements = state.size();
+        header.interval = this->interval;
+
+        auto bytes{reinterpret_cast<const std::byte *>(&header)};
+
+        buffer.reserve(buffer_size + max_operation_size);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(header));
+
+        try
+        {
+            start_chunk();
+        }
+
+        catch (...)
+        {
+            ::close(descriptor);
+            throw;
+        }
+    }
+
+    trace_writer(const trace_writer &) = delete;
+    trace_writer &operator=(const trace_writer &) = delete;
+
+    /**
+     * @brief
+     * Closes the file. A trace that was not finished has no footer, and
+     * readers reject it.
+     */
+    ~trace_writer()
+    {
+        if (descriptor >= 0)
+            ::close(descriptor);
+    }
+
+    void compare(std::size_t first, std::size_t second)
+    {
+        record({operation_kind::compare, static_cast<std::uint32_t>(first),
+                static_cast<std::uint32_t>(second)});
+    }
+
+    void swap(std::size_t first, std::size_t second)
+    {
+        record({operation_kind::swap, static_cast<std::uint32_t>(first),
+                static_cast<std::uint32_t>(second)});
+    }
+
+    template <typename V>
+    void write(std::size_t index, const V &value)
+    {
+        record({operation_kind::write, static_cast<std::uint32_t>(index),
+                static_cast<std::uint32_t>(value)});
+    }
+
+    /**
+     * @brief
+     * Writes the index and the footer, and closes the file.
+     */
+    void finish()
+    {
+        trace_footer footer{steps, index.size(), offset(), {}};
+
+        std::memcpy(footer.magic, trace_magic, sizeof(trace_magic));
+
+        flush();
+        write_all(index.data(), index.size() * sizeof(std::uint64_t));
+        write_all(&footer, sizeof(footer));
+
+        if (::close(std::exchange(descriptor, -1)) != 0)
+            fail("could not close the trace");
+    }
+
+    /**
+     * @brief
+     * Number of operations recorded so far.
+     * @return std::uint64_t Operations of the run
+     */
+    std::uint64_t size() const { return steps; }
+
+private:
+    static constexpr std::size_t min_interval{1 << 16};
+    static constexpr std::size_t buffer_size{1 << 20};
+    static constexpr std::size_t max_operation_size{20};
+
+    void record(const operation &op)
+    {
+        if (steps && steps % interval == 0)
+            start_chunk();
+
+        codec.encode(op, buffer);
+        apply_operation(state, op);
+        ++steps;
+
+        if (buffer.size() >= buffer_size)
+            flush();
+    }
+
+    /**
+     * @brief
+     * Indexes a new chunk and writes the data as it is now as its keyframe.
+     * The keyframe skips the buffer, it can be gigabytes long.
+     */
+    void start_chunk()
+    {
+        index.push_back(offset());
+        codec = {};
+
+        flush();
+        write_all(state.data(), state.size() * sizeof(int));
+    }
+
+    std::uint64_t offset() const { return written + buffer.size(); }
+
+    void flush()
+    {
+        write_all(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+    void write_all(const void *data, std::size_t size)
+    {
+        auto bytes{static_cast<const char *>(data)};
+
+        while (size)
+        {
+            auto count{::write(descriptor, bytes, size)};
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                fail("could not write the trace");
+            }
+
+            bytes += count;
+            size -= static_cast<std::size_t>(count);
+            written += static_cast<std::uint64_t>(count);
+        }
+    }
+
+    [[noreturn]] static void fail(const std::string &what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+    int descriptor{-1};
+    std::vector<int> state;
+    std::size_t interval;
+    std::vector<std::byte> buffer;
+    std::vector<std::uint64_t> index;
+    std::uint64_t written{};
+    std::uint64_t steps{};
+    trace_codec codec;
+};
+
+/**
+ * @brief
+ * Plays back a trace file. The file is mapped, so only the pages being
+ * decoded are read and a run of any length fits. Operations are handed
+ * out in order with the same interface as an operation_queue, and seeking
+ * starts from the keyframe before the step, which costs at most one chunk
+ * of operations. Errors of the file are reported as std::system_error,
+ * malformed files as std::runtime_error.
+ */
+class trace_reader
+{
+public:
+    /**
+     * @brief
+     * Construct a new trace reader
+     * @param path Path of the trace file
+     */
+    explicit trace_reader(const std::string &path)
+        : file{path, map_mode::read_only}
+    {
+        auto bytes{file.as<const std::byte>()};
+
+        if (bytes.size() < sizeof(trace_header) + sizeof(trace_footer))
+            throw std::runtime_error{path + " is not a trace file"};
+
+        trace_header header;
+        trace_footer footer;
+
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        std::memcpy(&footer, bytes.data() + bytes.size() - sizeof(footer),
+                    sizeof(footer));
+
+        if (std::memcmp(header.magic, trace_magic, sizeof(trace_magic)) ||
+            header.version != trace_version)
+            throw std::runtime_error{path + " is not a trace file"};
+
+        if (std::memcmp(footer.magic, trace_magic, sizeof(trace_magic)))
+            throw std::runtime_error{path + " is not a finished trace"};
+
+        elements = header.elements;
+        interval = header.interval;
+        steps = footer.steps;
+        base = bytes.data();
+        end = base + footer.index_offset;
+
+        auto index_end{bytes.size() - sizeof(footer)};
+        auto index_size{index_end - footer.index_offset};
+        auto keyframe_size{elements * sizeof(int)};
+
+        if (!interval || footer.index_offset > index_end ||
+            elements > footer.index_offset / sizeof(int) ||
+            index_size != footer.chunks * sizeof(std::uint64_t) ||
+            footer.chunks != std::max<std::uint64_t>(
+                                 1, (steps + interval - 1) / interval))
+            throw std::runtime_error{path + " has a corrupt index"};
+
+        index.resize(footer.chunks);
+        std::memcpy(index.data(), end, index_size);
+
+        for (std::size_t chunk{}; chunk < index.size(); ++chunk)
+        {
+            auto previous{chunk ? index[chunk - 1] + keyframe_size
+                                : sizeof(trace_header)};
+
+            if (index[chunk] < previous ||
+                index[chunk] > footer.index_offset - keyframe_size)
+                throw std::runtime_error{path + " has a corrupt index"};
+        }
+
+        file.advise(access_pattern::sequential);
+        enter_chunk(0);
+    }
+
+    /**
+     * @brief
+     * Moves the playback to a step and puts the data as it was before that
+     * step into data_vec.
+     * @param step Number of operations already applied
+     * @param data_vec Receives the data at that step
+     */
+    void seek(std::size_t step, std::vector<int> &data_vec)
+    {
+        step = std::min<std::size_t>(step, steps);
+
+        auto chunk{std::min(step / interval, index.size() - 1)};
+        auto keyframe{base + index[chunk]};
+
+        data_vec.resize(elements);
+
+        if (elements)
+            std::memcpy(data_vec.data(), keyframe, elements * sizeof(int));
+
+        enter_chunk(chunk);
+
+        while (next < step)
+            apply_operation(data_vec, decode());
+    }
+
+    /**
+     * @brief
+     * Hands out up to count operations in order.
+     * @tparam F Callable with a const operation &
+     * @param count Maximum number of operations
+     * @param function Receives the operations
+     * @return std::size_t Number of operations handed out
+     */
+    template <typename F>
+    std::size_t consume(std::size_t count, F &&function)
+    {
+        auto first{next};
+        auto last{std::min<std::uint64_t>(steps, next + count)};
+
+        while (next < last)
+            function(decode());
+
+        return static_cast<std::size_t>(last - first);
+    }
+
+    std::size_t size() const { return elements; }
+    std::uint64_t operations() const { return steps; }
+    std::size_t keyframe_interval() const { return interval; }
+    std::uint64_t position() const { return next; }
+
+private:
+    void enter_chunk(std::size_t chunk)
+    {
+        cursor = base + index[chunk] + elements * sizeof(int);
+        next = chunk * interval;
+        codec = {};
+    }
+
+    operation decode()
+    {
+        if (next && next % interval == 0)
+            enter_chunk(next / interval);
+
+        auto op{codec.decode(cursor, end)};
+
+        // Indices past the data would be written out of bounds
+        if (op.first >= elements ||
+            (op.kind != operation_kind::write && op.second >= elements))
+            throw std::runtime_error{"corrupt trace operation"};
+
+        ++next;
+
+        return op;
+    }
+
+    mapped_file file;
+    std::size_t elements;
+    std::size_t interval;
+    std::uint64_t steps;
+    std::vector<std::uint64_t> index;
+    const std::byte *base;
+    const std::byte *end;
+    const std::byte *cursor;
+    std::uint64_t next{};
+    trace_codec codec;
+};
+
+#endif //! TRACE_FILE_H